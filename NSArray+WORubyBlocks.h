@@ -30,10 +30,78 @@
 // macro headers
 #import "WOConvenienceMacros.h"
 
+@class WOLazyEnumerator;
+
 WO_DECLARE_CATEGORY_MARKER(NSArray, WORubyBlocks);
 
 @interface NSArray (WORubyBlocks)
 
 - (NSArray *)map:(id (^)(id))block;
 
+//! Returns a WOLazyEnumerator over the receiver, for chaining stages such as
+//! select, map and take into a single pass without intermediate arrays.
+- (WOLazyEnumerator *)lazy;
+
+//! Grain size which makes #parallelMap:grainSize: choose one itself.
+#define WO_AUTOMATIC_GRAIN_SIZE 0
+
+//! Concurrent form of #map: with an automatically chosen grain size. Only
+//! worthwhile when the block is expensive (parsing or hashing a file, say);
+//! for cheap blocks the coordination costs more than it saves.
+- (NSArray *)parallelMap:(id (^)(id))block;
+
+//! Concurrent form of #map: which splits the receiver into chunks of
+//! \p grainSize elements and maps the chunks on the global dispatch queue,
+//! so \p block must be safe to call from several threads at once. Results
+//! are returned in the receiver's order, with NSNull in place of nil.
+//!
+//! Setting \p *stop to YES cancels the map: chunks not yet started are
+//! skipped, running chunks stop after their current element, and the method
+//! returns nil. If \p block raises, the map is cancelled in the same way and
+//! the first exception is re-raised on the calling thread.
+//!
+//! Pass WO_AUTOMATIC_GRAIN_SIZE to have the grain size chosen from the
+//! element and processor counts; larger grains cost less to schedule, smaller
+//! ones balance uneven blocks better and cancel sooner.
+- (NSArray *)parallelMap:(id (^)(id object, BOOL *stop))block grainSize:(NSUInteger)grainSize;
+
+//! Returns a dictionary mapping each distinct key returned by \p block (NSNull
+//! standing in for nil) to an array of the elements which produced it, in
+//! the receiver's order. Each key is computed once and looked up in a hash
+//! table sized for the receiver, and each group's array is created once, at
+//! its final size.
+- (NSDictionary *)groupBy:(id (^)(id))block;
+
+//! Returns an array of two arrays: the elements for which \p block returns
+//! YES, then those for which it returns NO, each in the receiver's order.
+- (NSArray *)partition:(BOOL (^)(id))block;
+
+//! Returns a dictionary mapping each distinct key returned by \p block (NSNull
+//! standing in for nil) to the number of elements which produced it, as an
+//! NSNumber. Keys are computed once each, as in #groupBy:.
+- (NSDictionary *)tally:(id (^)(id))block;
+
+//! #parallelInject:block:grainSize: with an automatically chosen grain size.
+- (id)parallelInject:(id)initial block:(id (^)(id memo, id object))block;
+
+//! Concurrent reduction, in the manner of Ruby's inject, for associative
+//! blocks such as sums or merges of dictionaries. Each chunk of \p grainSize
+//! elements is reduced from its first element, then neighbouring chunk results
+//! are combined pairwise, in order, until one remains. \p block must be
+//! associative (though not necessarily commutative), safe to call from
+//! several threads at once, and accept its own results as either argument.
+//!
+//! Returns the reduction of the receiver combined with \p initial on the
+//! left, or just the reduction if \p initial is nil; returns \p initial if the
+//! receiver is empty. If \p block raises, the first exception is re-raised on
+//! the calling thread.
+- (id)parallelInject:(id)initial block:(id (^)(id memo, id object))block grainSize:(NSUInteger)grainSize;
+
+//! Returns the receiver's elements sorted by the keys \p block returns for
+//! them, compared with compare: (nil keys first). Each key is computed exactly
+//! once, concurrently, so \p block must be safe to call from several threads
+//! at once. The (key, index) pairs are then sorted with a parallel merge
+//! sort, so the result is stable: elements with equal keys keep their order.
+- (NSArray *)sortBy:(id (^)(id))block;
+
 @end
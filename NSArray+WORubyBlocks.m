@@ -25,20 +25,380 @@
 // POSSIBILITY OF SUCH DAMAGE.
 
 // category header
-#import "NSArray+WOConvenience.h"
+#import "NSArray+WORubyBlocks.h"
+
+// system headers
+#import <dispatch/dispatch.h>   /* dispatch_apply() */
+#import <libkern/OSAtomic.h>    /* OSAtomicCompareAndSwap32Barrier() */
+
+// macro headers
+#import "WODebugMacros.h"
+
+// other headers
+#import "WOLazyEnumerator.h"
+#import "WOMemory.h"
+
+//! Largest result count map: collects on the stack rather than the heap.
+#define WO_MAP_STACK_BUFFER_COUNT 128
+
+//! Number of chunks per processor aimed for by WO_AUTOMATIC_GRAIN_SIZE; more
+//! than one so that uneven blocks still keep every processor busy.
+#define WO_PARALLEL_CHUNKS_PER_PROCESSOR 8
+
+//! Runs no longer than this are sorted by insertion rather than merging.
+#define WO_SORT_INSERTION_THRESHOLD 16
+
+//! Key and original position of one element being sorted by sortBy:.
+typedef struct WOSortPair {
+
+    __strong id key;
+    NSUInteger  index;
+
+} WOSortPair;
+
+static NSUInteger WOResolveGrainSize(NSUInteger grainSize, NSUInteger count)
+{
+    if (grainSize != WO_AUTOMATIC_GRAIN_SIZE)
+        return grainSize;
+    NSUInteger processors = [[NSProcessInfo processInfo] activeProcessorCount];
+    return MAX(count / (processors * WO_PARALLEL_CHUNKS_PER_PROCESSOR), 1U);
+}
+
+//! Calls \p block with the bounds of each \p grainSize chunk of \p count
+//! elements, concurrently on the global queue, returning once all have
+//! finished. Chunks check \p *stopped to give up early; it is set when a
+//! chunk raises, and the first such exception is returned for the caller to
+//! re-raise on its own thread.
+static NSException *WOParallelApply(NSUInteger count, NSUInteger grainSize, volatile int32_t *stopped,
+                                    void (^block)(NSUInteger start, NSUInteger end))
+{
+    __block NSException *exception = nil;
+    size_t chunks = (count + grainSize - 1) / grainSize;
+    dispatch_apply(chunks, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t chunk) {
+        if (*stopped)
+            return;
+        NSUInteger start = chunk * grainSize;
+        @try
+        {
+            block(start, MIN(start + grainSize, count));
+        }
+        @catch (NSException *e)
+        {
+            // only the first exception is kept
+            if (OSAtomicCompareAndSwap32Barrier(0, 1, stopped))
+                exception = e;
+        }
+    });
+    return exception;
+}
+
+//! Orders by key, with nil keys first, then by original position, so that
+//! the sort is stable and no two pairs compare equal.
+WO_INLINE BOOL WOSortPairPrecedes(const WOSortPair *a, const WOSortPair *b)
+{
+    if (a->key != b->key)
+    {
+        if (!a->key || !b->key)
+            return !a->key;
+        NSComparisonResult order = [a->key compare:b->key];
+        if (order != NSOrderedSame)
+            return order == NSOrderedAscending;
+    }
+    return a->index < b->index;
+}
+
+//! Merges the sorted runs [\p left, \p middle) and [\p middle, \p end) of
+//! \p source into the same positions of \p destination.
+static void WOSortMerge(const WOSortPair *source, WOSortPair *destination, NSUInteger left, NSUInteger middle,
+                        NSUInteger end)
+{
+    NSUInteger i = left, j = middle, k = left;
+    while (i < middle && j < end)
+        destination[k++] = WOSortPairPrecedes(&source[j], &source[i]) ? source[j++] : source[i++];
+    while (i < middle)
+        destination[k++] = source[i++];
+    while (j < end)
+        destination[k++] = source[j++];
+}
+
+//! Sorts \p pairs[\p start, \p end) in place, using the same range of
+//! \p scratch.
+static void WOSortRun(WOSortPair *pairs, WOSortPair *scratch, NSUInteger start, NSUInteger end)
+{
+    if (end - start <= WO_SORT_INSERTION_THRESHOLD)
+    {
+        for (NSUInteger i = start + 1; i < end; i++)
+        {
+            WOSortPair pair = pairs[i];
+            NSUInteger j = i;
+            for (; j > start && WOSortPairPrecedes(&pair, &pairs[j - 1]); j--)
+                pairs[j] = pairs[j - 1];
+            pairs[j] = pair;
+        }
+        return;
+    }
+    NSUInteger middle = start + (end - start) / 2;
+    WOSortRun(pairs, scratch, start, middle);
+    WOSortRun(pairs, scratch, middle, end);
+    WOSortMerge(pairs, scratch, start, middle, end);
+    for (NSUInteger i = start; i < end; i++)    // assignment, not memcpy(), for the write barriers
+        pairs[i] = scratch[i];
+}
+
+//! Computes the key of each element of \p array with \p block, numbering the
+//! distinct keys in order of first appearance. Fills \p buckets with each
+//! element's key number, \p sizes (zeroed by the caller) with the number of
+//! elements having each key, and \p keys with the keys themselves; all three
+//! need room for [array count] entries. Returns the number of distinct keys.
+static NSUInteger WOBucketArray(NSArray *array, id (^block)(id), NSUInteger *buckets, NSUInteger *sizes,
+                                __strong id *keys)
+{
+    // unbounded (a capacity of 0) and left to grow: sizing for the worst case of
+    // every key being distinct wastes memory when there are few distinct keys,
+    // which is the common case; values are key numbers, not objects
+    CFMutableDictionaryRef table = CFDictionaryCreateMutable(kCFAllocatorDefault, 0,
+                                                             &kCFTypeDictionaryKeyCallBacks, NULL);
+    NSUInteger bucketCount = 0, i = 0;
+    for (id object in array)
+    {
+        id key = block(object);
+        if (!key)
+            key = [NSNull null];
+        const void *value;
+        NSUInteger bucket;
+        if (CFDictionaryGetValueIfPresent(table, key, &value))
+            bucket = (NSUInteger)value;
+        else
+        {
+            bucket = bucketCount++;
+            keys[bucket] = key;
+            CFDictionarySetValue(table, key, (const void *)bucket);
+        }
+        buckets[i++] = bucket;
+        sizes[bucket]++;
+    }
+    CFRelease(table);
+    return bucketCount;
+}
 
 WO_CATEGORY_MARKER(NSArray, WORubyBlocks);
 @implementation NSArray (WORubyBlocks)
 
 - (NSArray *)map:(id (^)(id))block
 {
-    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:[self count]];
+    // results go straight into a buffer from which the immutable array is
+    // built once, rather than growing a mutable array and copying it
+    NSUInteger count = [self count];
+    id stackResults[WO_MAP_STACK_BUFFER_COUNT];
+    __strong id *results = count <= WO_MAP_STACK_BUFFER_COUNT ? stackResults :
+        NSAllocateCollectable(count * sizeof(id), NSScannedOption);
+    NSUInteger i = 0;
     for (id object in self)
     {
         object = block(object);
-        [objects addObject:object ? object : [NSNull null]];
+        results[i++] = object ? object : [NSNull null];
+    }
+    return [NSArray arrayWithObjects:results count:i];
+}
+
+- (WOLazyEnumerator *)lazy
+{
+    return [WOLazyEnumerator enumeratorWithArray:self];
+}
+
+- (NSArray *)parallelMap:(id (^)(id))block
+{
+    WOParameterCheck(block != nil);
+    return [self parallelMap:^(id object, BOOL *stop) {
+        return block(object);
+    } grainSize:WO_AUTOMATIC_GRAIN_SIZE];
+}
+
+- (NSArray *)parallelMap:(id (^)(id object, BOOL *stop))block grainSize:(NSUInteger)grainSize
+{
+    WOParameterCheck(block != nil);
+    NSUInteger count = [self count];
+    if (count == 0)
+        return [NSArray array];
+
+    // scanned, so the collector sees results stored by the worker threads
+    __strong id *results = NSAllocateCollectable(count * sizeof(id), NSScannedOption);
+    __block volatile int32_t stopped = 0;
+    NSException *exception = WOParallelApply(count, WOResolveGrainSize(grainSize, count), &stopped,
+                                             ^(NSUInteger start, NSUInteger end) {
+        for (NSUInteger i = start; i < end && !stopped; i++)
+        {
+            BOOL stop = NO;
+            id result = block([self objectAtIndex:i], &stop);
+            results[i] = result ? result : [NSNull null];
+            if (stop)
+                OSAtomicCompareAndSwap32Barrier(0, 1, &stopped);
+        }
+    });
+    if (exception)
+        @throw exception;
+    return stopped ? nil : [NSArray arrayWithObjects:results count:count];
+}
+
+- (NSDictionary *)groupBy:(id (^)(id))block
+{
+    WOParameterCheck(block != nil);
+    NSUInteger count = [self count];
+    if (count == 0)
+        return [NSDictionary dictionary];
+    NSUInteger *buckets = emalloc(count * sizeof(NSUInteger));
+    NSUInteger *sizes = xcalloc(count, sizeof(NSUInteger));
+    __strong id *keys = NSAllocateCollectable(count * sizeof(id), NSScannedOption);
+    NSUInteger bucketCount = WOBucketArray(self, block, buckets, sizes, keys);
+
+    // counting sort: each group becomes a contiguous run, from which its
+    // array is made in one go; cursors start at each run's beginning and
+    // finish at its end
+    NSUInteger *cursors = emalloc(bucketCount * sizeof(NSUInteger));
+    for (NSUInteger bucket = 0, offset = 0; bucket < bucketCount; bucket++)
+        cursors[bucket] = (offset += sizes[bucket]) - sizes[bucket];
+    __strong id *grouped = NSAllocateCollectable(count * sizeof(id), NSScannedOption);
+    NSUInteger i = 0;
+    for (id object in self)
+        grouped[cursors[buckets[i++]]++] = object;
+    __strong id *groups = NSAllocateCollectable(bucketCount * sizeof(id), NSScannedOption);
+    for (NSUInteger bucket = 0; bucket < bucketCount; bucket++)
+        groups[bucket] = [NSArray arrayWithObjects:grouped + cursors[bucket] - sizes[bucket] count:sizes[bucket]];
+
+    NSDictionary *result = [NSDictionary dictionaryWithObjects:groups forKeys:keys count:bucketCount];
+    free(cursors);
+    free(sizes);
+    free(buckets);
+    return result;
+}
+
+- (NSArray *)partition:(BOOL (^)(id))block
+{
+    WOParameterCheck(block != nil);
+    NSUInteger count = [self count];
+    if (count == 0)
+        return [NSArray arrayWithObjects:[NSArray array], [NSArray array], nil];
+
+    // each answer is computed once, then both runs are laid out in one buffer
+    BOOL *selected = emalloc(count * sizeof(BOOL));
+    NSUInteger selectedCount = 0, i = 0;
+    for (id object in self)
+        if ((selected[i++] = block(object)))
+            selectedCount++;
+    __strong id *objects = NSAllocateCollectable(count * sizeof(id), NSScannedOption);
+    NSUInteger front = 0, back = selectedCount;
+    i = 0;
+    for (id object in self)
+        objects[selected[i++] ? front++ : back++] = object;
+    free(selected);
+    return [NSArray arrayWithObjects:
+            [NSArray arrayWithObjects:objects count:selectedCount],
+            [NSArray arrayWithObjects:objects + selectedCount count:count - selectedCount],
+            nil];
+}
+
+- (NSDictionary *)tally:(id (^)(id))block
+{
+    WOParameterCheck(block != nil);
+    NSUInteger count = [self count];
+    if (count == 0)
+        return [NSDictionary dictionary];
+    NSUInteger *buckets = emalloc(count * sizeof(NSUInteger));
+    NSUInteger *sizes = xcalloc(count, sizeof(NSUInteger));
+    __strong id *keys = NSAllocateCollectable(count * sizeof(id), NSScannedOption);
+    NSUInteger bucketCount = WOBucketArray(self, block, buckets, sizes, keys);
+    __strong id *tallies = NSAllocateCollectable(bucketCount * sizeof(id), NSScannedOption);
+    for (NSUInteger bucket = 0; bucket < bucketCount; bucket++)
+        tallies[bucket] = [NSNumber numberWithUnsignedInteger:sizes[bucket]];
+    NSDictionary *result = [NSDictionary dictionaryWithObjects:tallies forKeys:keys count:bucketCount];
+    free(sizes);
+    free(buckets);
+    return result;
+}
+
+- (id)parallelInject:(id)initial block:(id (^)(id memo, id object))block
+{
+    return [self parallelInject:initial block:block grainSize:WO_AUTOMATIC_GRAIN_SIZE];
+}
+
+- (id)parallelInject:(id)initial block:(id (^)(id memo, id object))block grainSize:(NSUInteger)grainSize
+{
+    WOParameterCheck(block != nil);
+    NSUInteger count = [self count];
+    if (count == 0)
+        return initial;
+    grainSize = WOResolveGrainSize(grainSize, count);
+
+    // reduce each chunk from its first element...
+    NSUInteger chunks = (count + grainSize - 1) / grainSize;
+    __strong id *partials = NSAllocateCollectable(chunks * sizeof(id), NSScannedOption);
+    __block volatile int32_t stopped = 0;
+    NSException *exception = WOParallelApply(count, grainSize, &stopped, ^(NSUInteger start, NSUInteger end) {
+        id memo = [self objectAtIndex:start];
+        for (NSUInteger i = start + 1; i < end && !stopped; i++)
+            memo = block(memo, [self objectAtIndex:i]);
+        partials[start / grainSize] = memo;
+    });
+
+    // ...then combine neighbouring partial results pairwise, in order, so
+    // that associativity is all that is required of the block
+    for (NSUInteger width = 1; width < chunks && !exception; width *= 2)
+    {
+        NSUInteger pairs = (chunks + 2 * width - 1) / (2 * width);
+        exception = WOParallelApply(pairs, 1, &stopped, ^(NSUInteger pair, NSUInteger end) {
+            NSUInteger left = pair * 2 * width, right = left + width;
+            if (right < chunks)
+                partials[left] = block(partials[left], partials[right]);
+        });
     }
-    return [objects copy]; // return immutable
+    if (exception)
+        @throw exception;
+    return initial ? block(initial, partials[0]) : partials[0];
+}
+
+- (NSArray *)sortBy:(id (^)(id))block
+{
+    WOParameterCheck(block != nil);
+    NSUInteger count = [self count];
+    if (count == 0)
+        return [NSArray array];
+    NSUInteger grainSize = WOResolveGrainSize(WO_AUTOMATIC_GRAIN_SIZE, count);
+
+    // compute every key exactly once
+    __strong WOSortPair *pairs = NSAllocateCollectable(count * sizeof(WOSortPair), NSScannedOption);
+    __strong WOSortPair *scratch = NSAllocateCollectable(count * sizeof(WOSortPair), NSScannedOption);
+    __block volatile int32_t stopped = 0;
+    NSException *exception = WOParallelApply(count, grainSize, &stopped, ^(NSUInteger start, NSUInteger end) {
+        for (NSUInteger i = start; i < end && !stopped; i++)
+            pairs[i] = (WOSortPair){ .key = block([self objectAtIndex:i]), .index = i };
+    });
+    if (exception)
+        @throw exception;
+
+    // sort chunks concurrently, then merge neighbouring runs in rounds, each
+    // round's merges running concurrently
+    exception = WOParallelApply(count, grainSize, &stopped, ^(NSUInteger start, NSUInteger end) {
+        WOSortRun(pairs, scratch, start, end);
+    });
+    __strong WOSortPair *source = pairs, *destination = scratch;
+    for (NSUInteger width = grainSize; width < count && !exception; width *= 2)
+    {
+        NSUInteger merges = (count + 2 * width - 1) / (2 * width);
+        exception = WOParallelApply(merges, 1, &stopped, ^(NSUInteger merge, NSUInteger end) {
+            NSUInteger left = merge * 2 * width;
+            WOSortMerge(source, destination, left, MIN(left + width, count), MIN(left + 2 * width, count));
+        });
+        __strong WOSortPair *swap = source;
+        source = destination;
+        destination = swap;
+    }
+    if (exception)
+        @throw exception;
+
+    __strong id *results = NSAllocateCollectable(count * sizeof(id), NSScannedOption);
+    for (NSUInteger i = 0; i < count; i++)
+        results[i] = [self objectAtIndex:source[i].index];
+    return [NSArray arrayWithObjects:results count:count];
 }
 
 @end
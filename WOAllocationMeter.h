@@ -0,0 +1,114 @@
+// WOAllocationMeter.h
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// superclass header
+#import "WOObject.h"
+
+// system headers
+#import <pthread.h>     /* pthread_t */
+#import <stdint.h>      /* int64_t */
+
+#pragma mark -
+#pragma mark Type definitions
+
+//! Allocation activity counted by a WOAllocationMeter. Byte counts are the
+//! sizes actually handed out or reclaimed by the allocator, which may be
+//! larger than the sizes requested.
+typedef struct WOAllocationCounts {
+
+    int64_t allocations;
+    int64_t frees;
+    int64_t bytesAllocated;
+    int64_t bytesFreed;
+
+} WOAllocationCounts;
+
+//! Counts the allocations, frees and bytes of the thread which creates it,
+//! while running.
+//!
+//! The first meter created installs wrappers around the functions of every
+//! malloc zone registered at that point, so it sees malloc() and
+//! non-collectable Core Foundation allocations; zones created afterwards are
+//! not tracked. Under garbage collection, collectable objects (Objective-C and
+//! Core Foundation objects alike) bypass the auto zone's malloc_zone_t
+//! functions, so calls to the collector's auto_zone_allocate_object() are
+//! wrapped as well, in every image loaded before or after the first meter.
+//! Collectable objects are reclaimed on the collector thread, so their frees
+//! are not counted. The wrappers stay installed, but cost only a load and a branch while no meter
+//! is running. Only the allocations of threads with a running meter are
+//! counted.
+//!
+//! Follows WOUsageMeter's model (running when created, stackable #pause and
+//! #resume), but must be paused and resumed on the creating thread. A meter
+//! must also be paused (until its pause count returns to zero) before it is
+//! dropped: a meter collected while running leaves its thread counting, and
+//! the wrappers active, for the life of the process. Zone interposition is
+//! only available on Darwin; see #isSupported.
+@interface WOAllocationMeter : WOObject {
+
+    pthread_t           owner;
+    int32_t             pauseCount;
+
+    //! Owning thread's counts at the time the receiver was put in motion.
+    WOAllocationCounts  last;
+    WOAllocationCounts  cumulative;
+}
+
+#pragma mark -
+#pragma mark Class methods
+
+//! Returns YES if allocations can be tracked on this system. If NO, meters
+//! can still be created but their counts stay zero and #countsString reports
+//! them as unavailable.
++ (BOOL)isSupported;
+
+//! Returns a meter in "running" state, counting the calling thread's
+//! allocations.
++ (WOAllocationMeter *)allocationMeter;
+
+#pragma mark -
+#pragma mark Custom methods
+
+//! Stackable (can send multiple pause messages); must be sent on the thread
+//! which created the receiver.
+- (void)pause;
+
+//! Stackable (can send multiple resume messages); must be sent on the thread
+//! which created the receiver.
+- (void)resume;
+
+//! Cumulative counts over all running intervals; must be sent on the thread
+//! which created the receiver if it is running.
+- (WOAllocationCounts)counts;
+
+//! Returns a string of the form "a allocations (b bytes), f frees (g bytes)".
+- (NSString *)countsString;
+
+//! Returns the counts as NSNumbers keyed by "allocations", "frees",
+//! "bytesAllocated" and "bytesFreed".
+- (NSDictionary *)countsDictionary;
+
+@end
@@ -0,0 +1,467 @@
+// WOAllocationMeter.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOAllocationMeter.h"
+
+// system headers
+#import <libkern/OSAtomic.h>    /* OSAtomicIncrement32Barrier(), OSAtomicDecrement32Barrier() */
+#ifdef __APPLE__
+#import <dlfcn.h>               /* dlsym() */
+#import <mach-o/dyld.h>         /* _dyld_register_func_for_add_image() */
+#import <mach-o/loader.h>       /* struct mach_header, struct segment_command */
+#import <mach-o/nlist.h>        /* struct nlist */
+#import <malloc/malloc.h>       /* malloc_zone_t, malloc_get_all_zones() */
+#import <mach/mach.h>           /* vm_protect(), vm_region_64() */
+#endif
+
+// macro headers
+#import "WOConvenienceMacros.h"
+#import "WODebugMacros.h"
+
+#pragma mark -
+#pragma mark Macros
+
+//! Maximum number of malloc zones wrapped.
+#define WO_ALLOCATION_MAX_ZONES 16
+
+#pragma mark -
+#pragma mark Type definitions
+
+//! Per-thread counts; only counted while at least one meter is running on
+//! the thread.
+typedef struct WOAllocationThread {
+    WOAllocationCounts  counts;
+    int32_t             running;
+} WOAllocationThread;
+
+#pragma mark -
+#pragma mark Static variables
+
+static pthread_once_t   WOAllocationInstallOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t    WOAllocationThreadKey;
+
+//! Number of meters running on any thread; the wrappers do nothing else
+//! while this is zero.
+static volatile int32_t WOAllocationRunningMeters = 0;
+
+#pragma mark -
+#pragma mark Static functions
+
+static WOAllocationThread *WOAllocationCurrentThread(BOOL create)
+{
+    WOAllocationThread *thread = pthread_getspecific(WOAllocationThreadKey);
+    if (!thread && create)
+    {
+        // not counted: nothing is running on this thread yet
+        thread = calloc(1, sizeof(WOAllocationThread));
+        pthread_setspecific(WOAllocationThreadKey, thread);
+    }
+    return thread;
+}
+
+#ifdef __APPLE__
+
+//! Unmodified copies of the wrapped zones, for calling through.
+typedef struct WOAllocationZone {
+    malloc_zone_t   *zone;
+    malloc_zone_t   original;
+} WOAllocationZone;
+
+static WOAllocationZone WOAllocationZones[WO_ALLOCATION_MAX_ZONES];
+static unsigned         WOAllocationZoneCount = 0;
+
+WO_INLINE malloc_zone_t *WOAllocationOriginal(malloc_zone_t *zone)
+{
+    for (unsigned i = 0; i < WOAllocationZoneCount; i++)
+        if (WOAllocationZones[i].zone == zone)
+            return &WOAllocationZones[i].original;
+    return NULL;    // not reached: only wrapped zones call the wrappers
+}
+
+//! Returns the calling thread's counts if a meter is running on it.
+WO_INLINE WOAllocationThread *WOAllocationCountingThread(void)
+{
+    if (WOAllocationRunningMeters == 0)
+        return NULL;
+    WOAllocationThread *thread = pthread_getspecific(WOAllocationThreadKey);
+    return (thread && thread->running > 0) ? thread : NULL;
+}
+
+WO_INLINE void WOAllocationNoteAllocation(malloc_zone_t *zone, malloc_zone_t *original, void *pointer)
+{
+    WOAllocationThread *thread = WOAllocationCountingThread();
+    if (thread && pointer)
+    {
+        thread->counts.allocations++;
+        thread->counts.bytesAllocated += original->size(zone, pointer);
+    }
+}
+
+WO_INLINE void WOAllocationNoteFree(malloc_zone_t *zone, malloc_zone_t *original, void *pointer, size_t size)
+{
+    WOAllocationThread *thread = WOAllocationCountingThread();
+    if (thread && pointer)
+    {
+        thread->counts.frees++;
+        thread->counts.bytesFreed += size ? size : original->size(zone, pointer);
+    }
+}
+
+static void *WOAllocationMalloc(malloc_zone_t *zone, size_t size)
+{
+    malloc_zone_t *original = WOAllocationOriginal(zone);
+    void *pointer = original->malloc(zone, size);
+    WOAllocationNoteAllocation(zone, original, pointer);
+    return pointer;
+}
+
+static void *WOAllocationCalloc(malloc_zone_t *zone, size_t count, size_t size)
+{
+    malloc_zone_t *original = WOAllocationOriginal(zone);
+    void *pointer = original->calloc(zone, count, size);
+    WOAllocationNoteAllocation(zone, original, pointer);
+    return pointer;
+}
+
+static void *WOAllocationValloc(malloc_zone_t *zone, size_t size)
+{
+    malloc_zone_t *original = WOAllocationOriginal(zone);
+    void *pointer = original->valloc(zone, size);
+    WOAllocationNoteAllocation(zone, original, pointer);
+    return pointer;
+}
+
+static void *WOAllocationRealloc(malloc_zone_t *zone, void *pointer, size_t size)
+{
+    malloc_zone_t *original = WOAllocationOriginal(zone);
+    WOAllocationNoteFree(zone, original, pointer, 0);
+    void *result = original->realloc(zone, pointer, size);
+    WOAllocationNoteAllocation(zone, original, result);
+    return result;
+}
+
+static void WOAllocationFree(malloc_zone_t *zone, void *pointer)
+{
+    malloc_zone_t *original = WOAllocationOriginal(zone);
+    WOAllocationNoteFree(zone, original, pointer, 0);
+    original->free(zone, pointer);
+}
+
+static unsigned WOAllocationBatchMalloc(malloc_zone_t *zone, size_t size, void **results, unsigned count)
+{
+    malloc_zone_t *original = WOAllocationOriginal(zone);
+    unsigned allocated = original->batch_malloc(zone, size, results, count);
+    for (unsigned i = 0; i < allocated; i++)
+        WOAllocationNoteAllocation(zone, original, results[i]);
+    return allocated;
+}
+
+static void WOAllocationBatchFree(malloc_zone_t *zone, void **pointers, unsigned count)
+{
+    malloc_zone_t *original = WOAllocationOriginal(zone);
+    for (unsigned i = 0; i < count; i++)
+        WOAllocationNoteFree(zone, original, pointers[i], 0);
+    original->batch_free(zone, pointers, count);
+}
+
+static void *WOAllocationMemalign(malloc_zone_t *zone, size_t alignment, size_t size)
+{
+    malloc_zone_t *original = WOAllocationOriginal(zone);
+    void *pointer = original->memalign(zone, alignment, size);
+    WOAllocationNoteAllocation(zone, original, pointer);
+    return pointer;
+}
+
+static void WOAllocationFreeDefiniteSize(malloc_zone_t *zone, void *pointer, size_t size)
+{
+    malloc_zone_t *original = WOAllocationOriginal(zone);
+    WOAllocationNoteFree(zone, original, pointer, size);
+    original->free_definite_size(zone, pointer, size);
+}
+
+//! Swaps the wrappers into \p zone, keeping a copy of the original.
+static void WOAllocationWrapZone(malloc_zone_t *zone)
+{
+    if (WOAllocationZoneCount == WO_ALLOCATION_MAX_ZONES)
+        return;
+
+    // zones are read-only from Mac OS X 10.7 onwards
+    vm_address_t                    address     = (vm_address_t)zone;
+    vm_size_t                       size        = 0;
+    vm_region_basic_info_data_64_t  info;
+    mach_msg_type_number_t          infoCount   = VM_REGION_BASIC_INFO_COUNT_64;
+    mach_port_t                     object;
+    BOOL readOnly = (vm_region_64(mach_task_self(), &address, &size, VM_REGION_BASIC_INFO_64,
+                                  (vm_region_info_t)&info, &infoCount, &object) == KERN_SUCCESS &&
+                     !(info.protection & VM_PROT_WRITE));
+    if (readOnly && vm_protect(mach_task_self(), (vm_address_t)zone, sizeof(malloc_zone_t), 0,
+                               VM_PROT_READ | VM_PROT_WRITE) != KERN_SUCCESS)
+        return;
+
+    WOAllocationZone *entry = &WOAllocationZones[WOAllocationZoneCount];
+    entry->zone     = zone;
+    entry->original = *zone;
+    WOAllocationZoneCount++;
+    OSMemoryBarrier();  // publish the original before any wrapper can run
+
+    zone->malloc    = WOAllocationMalloc;
+    zone->calloc    = WOAllocationCalloc;
+    zone->valloc    = WOAllocationValloc;
+    zone->realloc   = WOAllocationRealloc;
+    zone->free      = WOAllocationFree;
+    if (zone->batch_malloc)
+        zone->batch_malloc = WOAllocationBatchMalloc;
+    if (zone->batch_free)
+        zone->batch_free = WOAllocationBatchFree;
+    if (zone->version >= 5 && zone->memalign)
+        zone->memalign = WOAllocationMemalign;
+    if (zone->version >= 6 && zone->free_definite_size)
+        zone->free_definite_size = WOAllocationFreeDefiniteSize;
+
+    if (readOnly)
+        vm_protect(mach_task_self(), (vm_address_t)zone, sizeof(malloc_zone_t), 0, VM_PROT_READ);
+}
+
+#pragma mark -
+#pragma mark Collector allocations
+
+// Under garbage collection Objective-C objects (class_createInstance()) and
+// Core Foundation objects (_CFRuntimeCreateInstance()) are allocated with
+// auto_zone_allocate_object(), which never goes through the auto zone's
+// malloc_zone_t functions. Calls to it from other images are rebound to a
+// wrapper by rewriting their symbol pointers, as dyld itself does when
+// binding. Collectable memory is reclaimed on the collector thread, so only
+// the allocations are attributed to a metered thread, never the frees.
+
+#ifdef __LP64__
+typedef struct mach_header_64       WOAllocationMachHeader;
+typedef struct segment_command_64   WOAllocationSegment;
+typedef struct section_64           WOAllocationSection;
+typedef struct nlist_64             WOAllocationSymbol;
+#define WO_ALLOCATION_SEGMENT       LC_SEGMENT_64
+#else
+typedef struct mach_header          WOAllocationMachHeader;
+typedef struct segment_command      WOAllocationSegment;
+typedef struct section              WOAllocationSection;
+typedef struct nlist                WOAllocationSymbol;
+#define WO_ALLOCATION_SEGMENT       LC_SEGMENT
+#endif
+
+//! Signature of auto_zone_allocate_object() (libauto, not in the public SDK).
+typedef void *(*WOAllocationAutoAllocator)(malloc_zone_t *zone, size_t size, int type,
+                                           boolean_t initialRefcountToOne, boolean_t clear);
+
+static WOAllocationAutoAllocator WOAllocationAutoAllocateOriginal = NULL;
+
+static void *WOAllocationAutoAllocate(malloc_zone_t *zone, size_t size, int type,
+                                      boolean_t initialRefcountToOne, boolean_t clear)
+{
+    void *pointer = WOAllocationAutoAllocateOriginal(zone, size, type, initialRefcountToOne, clear);
+    WOAllocationThread *thread = WOAllocationCountingThread();
+    if (thread && pointer)
+    {
+        thread->counts.allocations++;
+        thread->counts.bytesAllocated += zone->size(zone, pointer);
+    }
+    return pointer;
+}
+
+//! Points every lazy and non-lazy symbol pointer for
+//! auto_zone_allocate_object() in the image at \p header at the wrapper.
+static void WOAllocationRebindImage(const struct mach_header *header, intptr_t slide)
+{
+    const WOAllocationSegment       *linkedit   = NULL;
+    const struct symtab_command     *symtab     = NULL;
+    const struct dysymtab_command   *dysymtab   = NULL;
+    const struct load_command       *command    = (const void *)((const WOAllocationMachHeader *)header + 1);
+    for (uint32_t i = 0; i < header->ncmds; i++, command = (const void *)((const char *)command + command->cmdsize))
+    {
+        if (command->cmd == WO_ALLOCATION_SEGMENT &&
+            strcmp(((const WOAllocationSegment *)command)->segname, SEG_LINKEDIT) == 0)
+            linkedit = (const void *)command;
+        else if (command->cmd == LC_SYMTAB)
+            symtab = (const void *)command;
+        else if (command->cmd == LC_DYSYMTAB)
+            dysymtab = (const void *)command;
+    }
+    if (!linkedit || !symtab || !dysymtab || !dysymtab->nindirectsyms)
+        return;
+
+    uintptr_t                   base        = (uintptr_t)slide + linkedit->vmaddr - linkedit->fileoff;
+    const WOAllocationSymbol    *symbols    = (const void *)(base + symtab->symoff);
+    const char                  *strings    = (const char *)(base + symtab->stroff);
+    const uint32_t              *indirect   = (const void *)(base + dysymtab->indirectsymoff);
+
+    command = (const void *)((const WOAllocationMachHeader *)header + 1);
+    for (uint32_t i = 0; i < header->ncmds; i++, command = (const void *)((const char *)command + command->cmdsize))
+    {
+        if (command->cmd != WO_ALLOCATION_SEGMENT ||
+            strcmp(((const WOAllocationSegment *)command)->segname, SEG_DATA) != 0)
+            continue;
+        const WOAllocationSegment *segment  = (const void *)command;
+        const WOAllocationSection *section  = (const void *)(segment + 1);
+        for (uint32_t j = 0; j < segment->nsects; j++, section++)
+        {
+            uint32_t type = section->flags & SECTION_TYPE;
+            if (type != S_LAZY_SYMBOL_POINTERS && type != S_NON_LAZY_SYMBOL_POINTERS)
+                continue;
+            void        **pointers  = (void **)((uintptr_t)slide + section->addr);
+            uint32_t    count       = (uint32_t)(section->size / sizeof(void *));
+            for (uint32_t k = 0; k < count; k++)
+            {
+                uint32_t index = indirect[section->reserved1 + k];
+                if (index & (INDIRECT_SYMBOL_LOCAL | INDIRECT_SYMBOL_ABS))
+                    continue;
+                if (strcmp(strings + symbols[index].n_un.n_strx, "_auto_zone_allocate_object") == 0)
+                    pointers[k] = (void *)WOAllocationAutoAllocate;
+            }
+        }
+    }
+}
+
+#endif /* __APPLE__ */
+
+static void WOAllocationInstall(void)
+{
+    pthread_key_create(&WOAllocationThreadKey, free);
+#ifdef __APPLE__
+    vm_address_t    *zones;
+    unsigned        count;
+    if (malloc_get_all_zones(mach_task_self(), NULL, &zones, &count) == KERN_SUCCESS)
+        for (unsigned i = 0; i < count; i++)
+            WOAllocationWrapZone((malloc_zone_t *)zones[i]);
+
+    // only present in garbage-collected processes; invoked for images loaded
+    // so far and for every image loaded later
+    WOAllocationAutoAllocateOriginal =
+        (WOAllocationAutoAllocator)dlsym(RTLD_DEFAULT, "auto_zone_allocate_object");
+    if (WOAllocationAutoAllocateOriginal)
+        _dyld_register_func_for_add_image(WOAllocationRebindImage);
+#endif
+}
+
+@implementation WOAllocationMeter
+
+#pragma mark -
+#pragma mark Class methods
+
++ (BOOL)isSupported
+{
+#ifdef __APPLE__
+    pthread_once(&WOAllocationInstallOnce, WOAllocationInstall);
+    return WOAllocationZoneCount > 0;
+#else
+    return NO;
+#endif
+}
+
++ (WOAllocationMeter *)allocationMeter
+{
+    return [[self alloc] init];
+}
+
+#pragma mark -
+#pragma mark NSObject overrides
+
+- (id)init
+{
+    if ((self = [super init]))
+    {
+        pthread_once(&WOAllocationInstallOnce, WOAllocationInstall);
+        owner = pthread_self();
+        [self resume];
+    }
+    return self;
+}
+
+#pragma mark -
+#pragma mark Custom methods
+
+- (void)pause
+{
+    WOCheck(pthread_equal(owner, pthread_self()));
+    if (--pauseCount == 0)  // pause when pause count hits 0
+    {
+        WOAllocationThread *thread = WOAllocationCurrentThread(YES);
+        thread->running--;
+        OSAtomicDecrement32Barrier(&WOAllocationRunningMeters);
+        cumulative.allocations      += thread->counts.allocations - last.allocations;
+        cumulative.frees            += thread->counts.frees - last.frees;
+        cumulative.bytesAllocated   += thread->counts.bytesAllocated - last.bytesAllocated;
+        cumulative.bytesFreed       += thread->counts.bytesFreed - last.bytesFreed;
+    }
+}
+
+- (void)resume
+{
+    WOCheck(pthread_equal(owner, pthread_self()));
+    if (++pauseCount == 1)  // resume when pause count moves from 0 to 1
+    {
+        WOAllocationThread *thread = WOAllocationCurrentThread(YES);
+        last = thread->counts;
+        OSAtomicIncrement32Barrier(&WOAllocationRunningMeters);
+        thread->running++;
+    }
+}
+
+- (WOAllocationCounts)counts
+{
+    WOAllocationCounts counts = cumulative;
+    if (pauseCount > 0)     // currently running
+    {
+        WOCheck(pthread_equal(owner, pthread_self()));
+        WOAllocationThread *thread = WOAllocationCurrentThread(YES);
+        counts.allocations      += thread->counts.allocations - last.allocations;
+        counts.frees            += thread->counts.frees - last.frees;
+        counts.bytesAllocated   += thread->counts.bytesAllocated - last.bytesAllocated;
+        counts.bytesFreed       += thread->counts.bytesFreed - last.bytesFreed;
+    }
+    return counts;
+}
+
+- (NSString *)countsString
+{
+    if (![[self class] isSupported])
+        return @"allocations unavailable";
+    WOAllocationCounts counts = [self counts];
+    return WO_STRING(@"%lld allocations (%lld bytes), %lld frees (%lld bytes)",
+                     (long long)counts.allocations, (long long)counts.bytesAllocated,
+                     (long long)counts.frees, (long long)counts.bytesFreed);
+}
+
+- (NSDictionary *)countsDictionary
+{
+    WOAllocationCounts counts = [self counts];
+    return [NSDictionary dictionaryWithObjectsAndKeys:
+            [NSNumber numberWithLongLong:counts.allocations],       @"allocations",
+            [NSNumber numberWithLongLong:counts.frees],             @"frees",
+            [NSNumber numberWithLongLong:counts.bytesAllocated],    @"bytesAllocated",
+            [NSNumber numberWithLongLong:counts.bytesFreed],        @"bytesFreed",
+            nil];
+}
+
+@end
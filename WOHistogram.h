@@ -0,0 +1,132 @@
+// WOHistogram.h
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// superclass header
+#import "WOObject.h"
+
+// other headers
+#import "WOUsageMeter.h"    /* WONanoseconds */
+
+#pragma mark -
+#pragma mark Macros
+
+//! Each power of two is divided into 2^WO_HISTOGRAM_SUB_BUCKET_BITS buckets,
+//! so recorded values are resolved to within 1/64 (about 1.6%).
+#define WO_HISTOGRAM_SUB_BUCKET_BITS    6
+
+//! Values of 2^WO_HISTOGRAM_MAX_VALUE_BITS nanoseconds (about 3.3 days) or
+//! more are clamped to the largest trackable value.
+#define WO_HISTOGRAM_MAX_VALUE_BITS     48
+
+#define WO_HISTOGRAM_MAX_VALUE          ((WONanoseconds)((1ULL << WO_HISTOGRAM_MAX_VALUE_BITS) - 1))
+
+//! Upper limit on the number of shards (and so on memory use, at roughly
+//! 22 KB per shard).
+#define WO_HISTOGRAM_MAX_SHARDS         16
+
+#pragma mark -
+#pragma mark Type definitions
+
+//! Opaque block of counters; see WOHistogram.m.
+typedef struct WOHistogramShard WOHistogramShard;
+
+//! A point-in-time digest of a histogram.
+typedef struct WOHistogramSummary {
+
+    uint64_t        count;
+    WONanoseconds   minimum;
+    WONanoseconds   maximum;
+    double          mean;
+    WONanoseconds   p50;
+    WONanoseconds   p90;
+    WONanoseconds   p99;
+    WONanoseconds   p999;
+
+} WOHistogramSummary;
+
+//! A log-bucketed ("HDR-style") histogram of nanosecond durations.
+//!
+//! Values are counted in buckets whose width grows with their magnitude, so
+//! memory is fixed regardless of how many values are recorded while the
+//! relative error stays constant. Percentiles are reported as the highest
+//! value equivalent to the bucket they fall in (never less than the true
+//! value), except that the maximum and minimum are exact.
+//!
+//! Recording threads are spread over up to WO_HISTOGRAM_MAX_SHARDS shards,
+//! hashed by thread, and update them with atomic adds and no locks; shards
+//! are allocated on first use. Readers merge all shards. A read taken while
+//! other threads are recording may miss some of their latest values, and is
+//! not a consistent snapshot: the sum, maximum and minimum may already
+//! reflect values which are not yet counted. Every value which is counted,
+//! however, is also reflected in the sum, maximum and minimum.
+@interface WOHistogram : WOObject {
+
+    WOHistogramShard * volatile shards[WO_HISTOGRAM_MAX_SHARDS];
+
+}
+
+#pragma mark -
+#pragma mark Class methods
+
++ (WOHistogram *)histogram;
+
+#pragma mark -
+#pragma mark Recording
+
+//! Records one value; negative values are recorded as 0.
+- (void)recordValue:(WONanoseconds)value;
+
+//! Zeroes all counts. Values recorded concurrently with a reset may or may
+//! not survive it.
+- (void)reset;
+
+#pragma mark -
+#pragma mark Reading
+
+//! Returns the value below or at which \p percentile percent (0 to 100) of
+//! the recorded values fall, or 0 if the histogram is empty.
+- (WONanoseconds)valueAtPercentile:(double)percentile;
+
+//! Merges the shards once and returns count, extremes, mean and the standard
+//! percentiles.
+- (WOHistogramSummary)summary;
+
+//! Returns a string of the form: "n=1000 min=... p50=... p90=... p99=...
+//! p999=... max=... (ns)"
+- (NSString *)summaryString;
+
+#pragma mark -
+#pragma mark Properties
+
+@property(readonly) uint64_t count;
+
+@end
+
+#pragma mark -
+#pragma mark Functions
+
+//! Equivalent to WOHistogram::recordValue:, without the message send.
+void WOHistogramRecord(WOHistogram *histogram, WONanoseconds value);
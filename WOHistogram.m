@@ -0,0 +1,304 @@
+// WOHistogram.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOHistogram.h"
+
+// system headers
+#import <libkern/OSAtomic.h>    /* OSAtomicIncrement64Barrier(), OSAtomicAdd64(), OSAtomicCompareAndSwap64() */
+#import <pthread.h>             /* pthread_self() */
+#import <stdint.h>              /* INT64_MAX */
+
+// macro headers
+#import "WOConvenienceMacros.h"
+
+// other headers
+#import "WOMemory.h"
+#import "WOMemoryBarrier.h"
+
+#pragma mark -
+#pragma mark Macros
+
+#define WO_HISTOGRAM_SUB_BUCKETS    (1 << WO_HISTOGRAM_SUB_BUCKET_BITS)
+
+//! Values below WO_HISTOGRAM_SUB_BUCKETS get a bucket each; each power of two
+//! from there up to WO_HISTOGRAM_MAX_VALUE gets WO_HISTOGRAM_SUB_BUCKETS
+//! buckets.
+#define WO_HISTOGRAM_BUCKETS        ((WO_HISTOGRAM_MAX_VALUE_BITS - WO_HISTOGRAM_SUB_BUCKET_BITS + 1) * WO_HISTOGRAM_SUB_BUCKETS)
+
+#pragma mark -
+#pragma mark Type definitions
+
+struct WOHistogramShard {
+    volatile int64_t    sum;
+    volatile int64_t    minimum;
+    volatile int64_t    maximum;
+    volatile int64_t    buckets[WO_HISTOGRAM_BUCKETS];
+};
+
+#pragma mark -
+#pragma mark Static functions
+
+//! Maps a value in [0, WO_HISTOGRAM_MAX_VALUE] to its bucket.
+//!
+//! Small values index directly. Otherwise the value is shifted right until
+//! only WO_HISTOGRAM_SUB_BUCKET_BITS + 1 significant bits remain; the shift
+//! selects a block of buckets and those bits the bucket within it.
+WO_INLINE unsigned WOHistogramBucket(WONanoseconds value)
+{
+    if (value < WO_HISTOGRAM_SUB_BUCKETS)
+        return (unsigned)value;
+    unsigned highest    = 63 - __builtin_clzll((unsigned long long)value);
+    unsigned shift      = highest - WO_HISTOGRAM_SUB_BUCKET_BITS;
+    return shift * WO_HISTOGRAM_SUB_BUCKETS + (unsigned)(value >> shift);
+}
+
+//! Returns the highest value which maps to \p bucket.
+WO_INLINE WONanoseconds WOHistogramBucketHighestValue(unsigned bucket)
+{
+    if (bucket < 2 * WO_HISTOGRAM_SUB_BUCKETS)
+        return bucket;
+    unsigned shift  = bucket / WO_HISTOGRAM_SUB_BUCKETS - 1;
+    WONanoseconds top = bucket - shift * WO_HISTOGRAM_SUB_BUCKETS;
+    return ((top + 1) << shift) - 1;
+}
+
+//! Spreads threads over the shards.
+WO_INLINE unsigned WOHistogramShardIndex(void)
+{
+    uint64_t thread = (uint64_t)(uintptr_t)pthread_self();
+    return (unsigned)((thread * 0x9E3779B97F4A7C15ULL) >> 32) % WO_HISTOGRAM_MAX_SHARDS;
+}
+
+static void WOHistogramResetShard(WOHistogramShard *shard)
+{
+    memset((void *)shard->buckets, 0, sizeof(shard->buckets));
+    shard->sum      = 0;
+    shard->maximum  = 0;
+    shard->minimum  = INT64_MAX;
+}
+
+//! Fills in \p values with the values at the ascending \p percentiles (each
+//! strictly between 0 and 100) in a single pass over merged \p buckets.
+static void WOHistogramPercentiles(const uint64_t *buckets, uint64_t count, const double *percentiles,
+                                   WONanoseconds *values, unsigned percentileCount,
+                                   WONanoseconds minimum, WONanoseconds maximum)
+{
+    unsigned next       = 0;
+    uint64_t running    = 0;
+    for (unsigned j = 0; j < WO_HISTOGRAM_BUCKETS && next < percentileCount; j++)
+    {
+        running += buckets[j];
+
+        // smallest bucket at which the running count reaches each rank
+        while (next < percentileCount)
+        {
+            uint64_t rank = (uint64_t)(percentiles[next] / 100.0 * count + 0.5);
+            if (running < MAX(rank, 1ULL))
+                break;
+            values[next++] = MAX(MIN(WOHistogramBucketHighestValue(j), maximum), minimum);
+        }
+    }
+    while (next < percentileCount)  // only if shards changed under us
+        values[next++] = maximum;
+}
+
+static uint64_t WOHistogramMerge(WOHistogram *histogram, uint64_t *buckets, int64_t *sum,
+                                 WONanoseconds *minimum, WONanoseconds *maximum);
+
+@implementation WOHistogram
+
+#pragma mark -
+#pragma mark Class methods
+
++ (WOHistogram *)histogram
+{
+    return [[self alloc] init];
+}
+
+#pragma mark -
+#pragma mark NSObject overrides
+
+- (void)finalize
+{
+    for (unsigned i = 0; i < WO_HISTOGRAM_MAX_SHARDS; i++)
+        free(shards[i]);
+    [super finalize];
+}
+
+#pragma mark -
+#pragma mark Recording
+
+- (void)recordValue:(WONanoseconds)value
+{
+    WOHistogramRecord(self, value);
+}
+
+- (void)reset
+{
+    for (unsigned i = 0; i < WO_HISTOGRAM_MAX_SHARDS; i++)
+        if (shards[i])
+            WOHistogramResetShard(shards[i]);
+}
+
+#pragma mark -
+#pragma mark Reading
+
+- (WONanoseconds)valueAtPercentile:(double)percentile
+{
+    uint64_t        *buckets = xcalloc(WO_HISTOGRAM_BUCKETS, sizeof(uint64_t));
+    int64_t         sum;
+    WONanoseconds   minimum, maximum;
+    uint64_t        count = WOHistogramMerge(self, buckets, &sum, &minimum, &maximum);
+    WONanoseconds   value = 0;
+    if (count > 0)
+    {
+        if (percentile <= 0.0)
+            value = minimum;
+        else if (percentile >= 100.0)
+            value = maximum;
+        else
+            WOHistogramPercentiles(buckets, count, &percentile, &value, 1, minimum, maximum);
+    }
+    free(buckets);
+    return value;
+}
+
+- (WOHistogramSummary)summary
+{
+    WOHistogramSummary  summary = { 0, 0, 0, 0.0, 0, 0, 0, 0 };
+    uint64_t            *buckets = xcalloc(WO_HISTOGRAM_BUCKETS, sizeof(uint64_t));
+    int64_t             sum;
+    WONanoseconds       minimum, maximum;
+    uint64_t            count = WOHistogramMerge(self, buckets, &sum, &minimum, &maximum);
+    if (count > 0)
+    {
+        double          percentiles[4]  = { 50.0, 90.0, 99.0, 99.9 };
+        WONanoseconds   values[4];
+        WOHistogramPercentiles(buckets, count, percentiles, values, 4, minimum, maximum);
+        summary.count   = count;
+        summary.minimum = minimum;
+        summary.maximum = maximum;
+        summary.mean    = (double)sum / count;
+        summary.p50     = values[0];
+        summary.p90     = values[1];
+        summary.p99     = values[2];
+        summary.p999    = values[3];
+    }
+    free(buckets);
+    return summary;
+}
+
+- (NSString *)summaryString
+{
+    WOHistogramSummary summary = [self summary];
+    return WO_STRING(@"n=%llu min=%lld p50=%lld p90=%lld p99=%lld p999=%lld max=%lld (ns)",
+                     (unsigned long long)summary.count, (long long)summary.minimum, (long long)summary.p50,
+                     (long long)summary.p90, (long long)summary.p99, (long long)summary.p999,
+                     (long long)summary.maximum);
+}
+
+#pragma mark -
+#pragma mark Properties
+
+- (uint64_t)count
+{
+    uint64_t count = 0;
+    for (unsigned i = 0; i < WO_HISTOGRAM_MAX_SHARDS; i++)
+        if (shards[i])
+            for (unsigned j = 0; j < WO_HISTOGRAM_BUCKETS; j++)
+                count += shards[i]->buckets[j];
+    return count;
+}
+
+#pragma mark -
+#pragma mark Functions
+
+// defined within the implementation for direct access to the histogram's instance variables
+
+//! Sums all shards into \p buckets (which must be zeroed) and returns the
+//! total count.
+static uint64_t WOHistogramMerge(WOHistogram *histogram, uint64_t *buckets, int64_t *sum,
+                                 WONanoseconds *minimum, WONanoseconds *maximum)
+{
+    uint64_t count = 0;
+    *sum        = 0;
+    *minimum    = INT64_MAX;
+    *maximum    = 0;
+    for (unsigned i = 0; i < WO_HISTOGRAM_MAX_SHARDS; i++)
+    {
+        WOHistogramShard *shard = histogram->shards[i];
+        if (!shard)
+            continue;
+        for (unsigned j = 0; j < WO_HISTOGRAM_BUCKETS; j++)
+        {
+            uint64_t bucket = shard->buckets[j];
+            buckets[j]      += bucket;
+            count           += bucket;
+        }
+
+        // read after the buckets: everything counted so far is included
+        WO_READ_MEMORY_BARRIER();
+        *sum        += shard->sum;
+        *minimum    = MIN(*minimum, shard->minimum);
+        *maximum    = MAX(*maximum, shard->maximum);
+    }
+    return count;
+}
+
+void WOHistogramRecord(WOHistogram *histogram, WONanoseconds value)
+{
+    if (value < 0)
+        value = 0;
+    else if (value > WO_HISTOGRAM_MAX_VALUE)
+        value = WO_HISTOGRAM_MAX_VALUE;
+
+    unsigned            index = WOHistogramShardIndex();
+    WOHistogramShard    *shard = histogram->shards[index];
+    if (!shard)
+    {
+        // first value from this shard's threads: racing allocators keep the winner's shard
+        shard = emalloc(sizeof(WOHistogramShard));
+        WOHistogramResetShard(shard);
+        if (!OSAtomicCompareAndSwapPtrBarrier(NULL, shard, (void * volatile *)&histogram->shards[index]))
+        {
+            free(shard);
+            shard = histogram->shards[index];
+        }
+    }
+
+    // the bucket goes last, so a reader which counts the value also sees it
+    // in the sum and within the maximum and minimum
+    OSAtomicAdd64(value, &shard->sum);
+    int64_t current;
+    while ((current = shard->maximum) < value && !OSAtomicCompareAndSwap64(current, value, &shard->maximum))
+        ;
+    while ((current = shard->minimum) > value && !OSAtomicCompareAndSwap64(current, value, &shard->minimum))
+        ;
+    OSAtomicIncrement64Barrier(&shard->buckets[WOHistogramBucket(value)]);
+}
+
+@end
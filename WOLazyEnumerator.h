@@ -0,0 +1,102 @@
+// WOLazyEnumerator.h
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// superclass header
+#import "WOObject.h"
+
+//! A lazily evaluated chain of enumeration stages over an array, in the
+//! manner of Ruby's Enumerator::Lazy. Obtain one with -[NSArray lazy].
+//!
+//! The stage methods (#select:, #reject:, #map:, #take:, #takeWhile: and
+//! #eachSlice:) do no work: each returns a new enumerator with the stage
+//! appended, leaving the receiver usable on its own. Only a terminal method
+//! (#allObjects, #each: or #inject:block:) enumerates, and it makes a single
+//! pass over the source, feeding each element through every stage in turn,
+//! so no intermediate arrays are created however long the chain. Stages
+//! which finish early (#take:, #takeWhile:) end the pass at once.
+//!
+//! \code
+//! NSArray *names = [[[[people lazy] select:^(id person) {
+//!     return [person isActive];
+//! }] map:^(id person) {
+//!     return (id)[person name];
+//! }] take:10] allObjects];
+//! \endcode
+@interface WOLazyEnumerator : WOObject {
+
+    NSArray *source;
+
+    //! Stages in the order they apply.
+    NSArray *stages;
+}
+
+#pragma mark -
+#pragma mark Creation
+
+//! Returns an enumerator with no stages over \p anArray.
++ (WOLazyEnumerator *)enumeratorWithArray:(NSArray *)anArray;
+
+//! Designated initializer.
+- (id)initWithArray:(NSArray *)anArray;
+
+#pragma mark -
+#pragma mark Stages
+
+//! Passes on the elements for which \p block returns YES.
+- (WOLazyEnumerator *)select:(BOOL (^)(id))block;
+
+//! Passes on the elements for which \p block returns NO.
+- (WOLazyEnumerator *)reject:(BOOL (^)(id))block;
+
+//! Passes on the result of \p block for each element, with NSNull in place of
+//! nil as in -[NSArray map:].
+- (WOLazyEnumerator *)map:(id (^)(id))block;
+
+//! Passes on at most the first \p count elements.
+- (WOLazyEnumerator *)take:(NSUInteger)count;
+
+//! Passes on elements until \p block first returns NO.
+- (WOLazyEnumerator *)takeWhile:(BOOL (^)(id))block;
+
+//! Passes on arrays of \p count consecutive elements; the last may be
+//! shorter. Raises an NSInternalInconsistencyException if \p count is 0.
+- (WOLazyEnumerator *)eachSlice:(NSUInteger)count;
+
+#pragma mark -
+#pragma mark Terminal operations
+
+//! Runs the chain and returns its output as an array.
+- (NSArray *)allObjects;
+
+//! Runs the chain, calling \p block with each output element.
+- (void)each:(void (^)(id))block;
+
+//! Runs the chain, folding its output into an accumulator which starts as
+//! \p initial and is replaced by the result of \p block for each element.
+//! Returns the final accumulator.
+- (id)inject:(id)initial block:(id (^)(id memo, id object))block;
+
+@end
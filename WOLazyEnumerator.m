@@ -0,0 +1,314 @@
+// WOLazyEnumerator.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOLazyEnumerator.h"
+
+// macro headers
+#import "WOConvenienceMacros.h"
+#import "WODebugMacros.h"
+
+#pragma mark -
+#pragma mark Macros
+
+//! Largest output allObjects collects on the stack rather than the heap.
+#define WO_LAZY_STACK_BUFFER_COUNT 128
+
+#pragma mark -
+#pragma mark Type definitions
+
+typedef enum WOLazyStageKind {
+
+    WOLazySelect,
+    WOLazyReject,
+    WOLazyMap,
+    WOLazyTake,
+    WOLazyTakeWhile,
+    WOLazyEachSlice
+
+} WOLazyStageKind;
+
+//! Immutable description of one stage; shared by every enumerator derived
+//! from the one it was added to.
+@interface WOLazyStage : NSObject {
+
+@public
+    WOLazyStageKind kind;
+    id              block;
+    NSUInteger      count;
+}
+
+- (id)initWithKind:(WOLazyStageKind)aKind block:(id)aBlock count:(NSUInteger)aCount;
+
+@end
+
+@implementation WOLazyStage
+
+- (id)initWithKind:(WOLazyStageKind)aKind block:(id)aBlock count:(NSUInteger)aCount
+{
+    if ((self = [super init]))
+    {
+        kind    = aKind;
+        block   = [aBlock copy];
+        count   = aCount;
+    }
+    return self;
+}
+
+@end
+
+//! State of one stage during a single pass, so that an enumerator can be run
+//! any number of times (and on several threads at once).
+typedef struct WOLazyStageState {
+
+    WOLazyStageKind kind;
+    id              block;      // owned by the WOLazyStage
+    NSUInteger      count;
+
+    //! Elements passed on so far by a take stage.
+    NSUInteger      taken;
+
+    //! Partial slice of an eachSlice stage; scanned, as mapped elements may
+    //! be referenced from nowhere else.
+    __strong id     *slice;
+    NSUInteger      sliceCount;
+
+} WOLazyStageState;
+
+#pragma mark -
+#pragma mark Static functions
+
+//! Feeds \p object through the stages from \p index onwards, handing what
+//! comes out of the last stage to \p sink. Returns NSNotFound to continue the
+//! pass, or the index of the stage which has finished it.
+static NSUInteger WOLazyPush(WOLazyStageState *states, NSUInteger stageCount, NSUInteger index, id object,
+                             void (^sink)(id))
+{
+    for (; index < stageCount; index++)
+    {
+        WOLazyStageState *state = &states[index];
+        switch (state->kind)
+        {
+            case WOLazySelect:
+                if (!((BOOL (^)(id))state->block)(object))
+                    return NSNotFound;
+                break;
+            case WOLazyReject:
+                if (((BOOL (^)(id))state->block)(object))
+                    return NSNotFound;
+                break;
+            case WOLazyMap:
+                object = ((id (^)(id))state->block)(object);
+                if (!object)
+                    object = [NSNull null];
+                break;
+            case WOLazyTake:
+                if (state->taken == state->count)
+                    return index;
+                if (++state->taken == state->count)
+                {
+                    // the last element still goes downstream; stages there
+                    // may themselves finish the pass first
+                    NSUInteger finished = WOLazyPush(states, stageCount, index + 1, object, sink);
+                    return finished == NSNotFound ? index : finished;
+                }
+                break;
+            case WOLazyTakeWhile:
+                if (!((BOOL (^)(id))state->block)(object))
+                    return index;
+                break;
+            case WOLazyEachSlice:
+                state->slice[state->sliceCount++] = object;
+                if (state->sliceCount < state->count)
+                    return NSNotFound;
+                object = [NSArray arrayWithObjects:state->slice count:state->sliceCount];
+                state->sliceCount = 0;
+                break;
+        }
+    }
+    sink(object);
+    return NSNotFound;
+}
+
+//! Passes partial slices downstream once the source is exhausted or the stage
+//! before \p index has finished the pass; slices upstream of a finished stage
+//! are dropped, as nothing more may pass through it.
+static void WOLazyFlush(WOLazyStageState *states, NSUInteger stageCount, NSUInteger index, void (^sink)(id))
+{
+    for (; index < stageCount; index++)
+    {
+        WOLazyStageState *state = &states[index];
+        if (state->kind != WOLazyEachSlice || state->sliceCount == 0)
+            continue;
+        NSArray *slice = [NSArray arrayWithObjects:state->slice count:state->sliceCount];
+        state->sliceCount = 0;
+        NSUInteger finished = WOLazyPush(states, stageCount, index + 1, slice, sink);
+        if (finished != NSNotFound)
+            index = finished;
+    }
+}
+
+@interface WOLazyEnumerator ()
+
+- (id)initWithArray:(NSArray *)anArray stages:(NSArray *)someStages;
+
+- (WOLazyEnumerator *)enumeratorByAddingStage:(WOLazyStageKind)kind block:(id)block count:(NSUInteger)count;
+
+//! Makes one pass, handing each output element to \p sink.
+- (void)run:(void (^)(id))sink;
+
+@end
+
+@implementation WOLazyEnumerator
+
+#pragma mark -
+#pragma mark Creation
+
++ (WOLazyEnumerator *)enumeratorWithArray:(NSArray *)anArray
+{
+    return [[self alloc] initWithArray:anArray];
+}
+
+- (id)initWithArray:(NSArray *)anArray
+{
+    return [self initWithArray:anArray stages:[NSArray array]];
+}
+
+- (id)initWithArray:(NSArray *)anArray stages:(NSArray *)someStages
+{
+    WOParameterCheck(anArray != nil);
+    if ((self = [super init]))
+    {
+        source = anArray;
+        stages = someStages;
+    }
+    return self;
+}
+
+- (WOLazyEnumerator *)enumeratorByAddingStage:(WOLazyStageKind)kind block:(id)block count:(NSUInteger)count
+{
+    WOLazyStage *stage = [[WOLazyStage alloc] initWithKind:kind block:block count:count];
+    return [[WOLazyEnumerator alloc] initWithArray:source stages:[stages arrayByAddingObject:stage]];
+}
+
+#pragma mark -
+#pragma mark Stages
+
+- (WOLazyEnumerator *)select:(BOOL (^)(id))block
+{
+    WOParameterCheck(block != nil);
+    return [self enumeratorByAddingStage:WOLazySelect block:block count:0];
+}
+
+- (WOLazyEnumerator *)reject:(BOOL (^)(id))block
+{
+    WOParameterCheck(block != nil);
+    return [self enumeratorByAddingStage:WOLazyReject block:block count:0];
+}
+
+- (WOLazyEnumerator *)map:(id (^)(id))block
+{
+    WOParameterCheck(block != nil);
+    return [self enumeratorByAddingStage:WOLazyMap block:block count:0];
+}
+
+- (WOLazyEnumerator *)take:(NSUInteger)count
+{
+    return [self enumeratorByAddingStage:WOLazyTake block:nil count:count];
+}
+
+- (WOLazyEnumerator *)takeWhile:(BOOL (^)(id))block
+{
+    WOParameterCheck(block != nil);
+    return [self enumeratorByAddingStage:WOLazyTakeWhile block:block count:0];
+}
+
+- (WOLazyEnumerator *)eachSlice:(NSUInteger)count
+{
+    WOParameterCheck(count > 0);
+    return [self enumeratorByAddingStage:WOLazyEachSlice block:nil count:count];
+}
+
+#pragma mark -
+#pragma mark Terminal operations
+
+- (void)run:(void (^)(id))sink
+{
+    NSUInteger stageCount = [stages count];
+    WOLazyStageState states[stageCount + 1];    // never zero-length
+    for (NSUInteger i = 0; i < stageCount; i++)
+    {
+        WOLazyStage *stage = [stages objectAtIndex:i];
+        states[i] = (WOLazyStageState){ .kind = stage->kind, .block = stage->block, .count = stage->count };
+        if (stage->kind == WOLazyEachSlice)
+            states[i].slice = NSAllocateCollectable(stage->count * sizeof(id), NSScannedOption);
+    }
+
+    NSUInteger finished = NSNotFound;
+    for (id object in source)
+    {
+        if ((finished = WOLazyPush(states, stageCount, 0, object, sink)) != NSNotFound)
+            break;
+    }
+    WOLazyFlush(states, stageCount, finished == NSNotFound ? 0 : finished + 1, sink);
+}
+
+- (NSArray *)allObjects
+{
+    // no stage passes on more elements than it receives, so the source count
+    // (or the smallest take) bounds the output
+    NSUInteger bound = [source count];
+    for (WOLazyStage *stage in stages)
+        if (stage->kind == WOLazyTake)
+            bound = MIN(bound, stage->count);
+
+    id stackResults[WO_LAZY_STACK_BUFFER_COUNT];
+    __strong id *results = bound <= WO_LAZY_STACK_BUFFER_COUNT ? stackResults :
+        NSAllocateCollectable(bound * sizeof(id), NSScannedOption);
+    __block NSUInteger count = 0;
+    [self run:^(id object) {
+        results[count++] = object;
+    }];
+    return [NSArray arrayWithObjects:results count:count];
+}
+
+- (void)each:(void (^)(id))block
+{
+    WOParameterCheck(block != nil);
+    [self run:block];
+}
+
+- (id)inject:(id)initial block:(id (^)(id memo, id object))block
+{
+    WOParameterCheck(block != nil);
+    __block id memo = initial;
+    [self run:^(id object) {
+        memo = block(memo, object);
+    }];
+    return memo;
+}
+
+@end
@@ -0,0 +1,90 @@
+// WOLogFileSink.h
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// superclass header
+#import "WOLogSink.h"
+
+// system headers
+#import <limits.h>      /* PIPE_BUF */
+
+//! Largest record which is written with a single O_APPEND write(). Such a
+//! write lands at the end of the file as one contiguous run even when several
+//! processes append to the same file at once, so no lock is needed.
+#define WO_LOG_ATOMIC_APPEND_SIZE PIPE_BUF
+
+//! First byte of a fragment frame (ASCII "record separator").
+#define WO_LOG_FRAGMENT_MARKER  '\036'
+
+//! Appends records to a file. The file is opened (and created if necessary)
+//! when the first record is written and held open thereafter.
+//!
+//! The file is never locked. Records of up to WO_LOG_ATOMIC_APPEND_SIZE bytes
+//! are appended with a single write() and so are never interleaved with those
+//! of other processes writing to the same file. Longer records are split into
+//! fragments, each written atomically with a frame header line of the form:
+//!
+//! \code
+//! <WO_LOG_FRAGMENT_MARKER>pid.sequence index/count length\n
+//! \endcode
+//!
+//! followed by \c length bytes of the record. Fragments from different
+//! processes may be interleaved in the file; #reassembleData: restores the
+//! original records.
+@interface WOLogFileSink : WOLogSink {
+
+    NSString            *path;
+
+    //! -1 until opened; set with compare-and-swap so that concurrent callers
+    //! of #appendBytes:length: open the file only once.
+    volatile int32_t    descriptor;
+
+}
+
+//! Designated initializer.
+//!
+//! \throws NSInternalInconsistencyException Throws an exception if \p aPath is
+//! nil.
+- (id)initWithPath:(NSString *)aPath;
+
+//! Appends \p length bytes to the file as described above. Unlike
+//! #submitRecord: this writes synchronously on the calling thread; it is
+//! thread-safe and may be called concurrently with queued writes. Returns NO
+//! if the file could not be opened or written.
+- (BOOL)appendBytes:(const void *)bytes length:(size_t)length;
+
+//! Returns a copy of \p data (the contents of a file written by one or more
+//! WOLogFileSink instances) in which each set of fragments has been replaced
+//! by the record it came from, at the position of its final fragment.
+//! Records with missing fragments (for example, because the writing process
+//! crashed) are omitted.
+//!
+//! \throws NSInternalInconsistencyException Throws an exception if \p data is
+//! nil.
++ (NSData *)reassembleData:(NSData *)data;
+
+@property(readonly, copy) NSString *path;
+
+@end
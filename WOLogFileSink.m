@@ -0,0 +1,175 @@
+// WOLogFileSink.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOLogFileSink.h"
+
+// system headers
+#import <fcntl.h>               /* open() */
+#import <libkern/OSAtomic.h>    /* OSAtomicCompareAndSwap32Barrier() etc */
+#import <unistd.h>              /* write(), close() */
+
+// macro headers
+#import "WOConvenienceMacros.h"
+#import "WODebugMacros.h"
+
+//! Room reserved in each fragment for the frame header line.
+#define WO_LOG_FRAGMENT_HEADER_SIZE 64
+
+//! Numbers the oversized records written by this process, so that their
+//! fragments can be told apart from those of other records.
+static volatile int32_t WOLogFragmentSequence = 0;
+
+@implementation WOLogFileSink
+
+- (id)initWithPath:(NSString *)aPath
+{
+    WOParameterCheck(aPath != nil);
+    if ((self = [super init]))
+    {
+        path        = [aPath copy];
+        descriptor  = -1;
+    }
+    return self;
+}
+
+- (void)finalize
+{
+    if (descriptor >= 0)
+        close(descriptor);
+    [super finalize];
+}
+
+- (void)writeRecord:(WOLogRecord *)record
+{
+    NSData *data = [record data];
+    if (![self appendBytes:[data bytes] length:[data length]])
+        [self recordDropped];
+}
+
+- (BOOL)appendBytes:(const void *)bytes length:(size_t)length
+{
+    int fd = descriptor;
+    if (fd < 0)
+    {
+        fd = open([path fileSystemRepresentation], O_CREAT | O_WRONLY | O_APPEND, 0644);
+        if (fd < 0)
+            return NO;
+        if (!OSAtomicCompareAndSwap32Barrier(-1, fd, &descriptor))
+        {
+            close(fd);  // lost the race to another thread
+            fd = descriptor;
+        }
+    }
+
+    if (length <= WO_LOG_ATOMIC_APPEND_SIZE)
+        return write(fd, bytes, length) == (ssize_t)length;
+
+    // too long to append atomically: split into framed fragments
+    const size_t chunkSize  = WO_LOG_ATOMIC_APPEND_SIZE - WO_LOG_FRAGMENT_HEADER_SIZE;
+    unsigned count          = (unsigned)((length + chunkSize - 1) / chunkSize);
+    unsigned sequence       = (unsigned)OSAtomicIncrement32Barrier(&WOLogFragmentSequence);
+    char fragment[WO_LOG_ATOMIC_APPEND_SIZE];
+    for (unsigned index = 0; index < count; index++)
+    {
+        size_t offset       = index * chunkSize;
+        size_t chunkLength  = MIN(chunkSize, length - offset);
+        int headerLength    = snprintf(fragment, WO_LOG_FRAGMENT_HEADER_SIZE, "%c%d.%u %u/%u %u\n",
+                                       WO_LOG_FRAGMENT_MARKER, getpid(), sequence, index, count,
+                                       (unsigned)chunkLength);
+        memcpy(fragment + headerLength, (const char *)bytes + offset, chunkLength);
+        size_t fragmentLength = headerLength + chunkLength;
+        if (write(fd, fragment, fragmentLength) != (ssize_t)fragmentLength)
+            return NO;
+    }
+    return YES;
+}
+
++ (NSData *)reassembleData:(NSData *)data
+{
+    WOParameterCheck(data != nil);
+    const char *bytes   = [data bytes];
+    size_t length       = [data length];
+    NSMutableData *result = [NSMutableData dataWithCapacity:length];
+
+    // "pid.sequence" -> array of fragments, NSNull until received
+    NSMutableDictionary *partial = [NSMutableDictionary dictionary];
+    size_t position = 0;
+    while (position < length)
+    {
+        // every write starts either a plain record or a fragment frame
+        if (bytes[position] == WO_LOG_FRAGMENT_MARKER)
+        {
+            int pid;
+            unsigned sequence, index, count, chunkLength;
+            char header[WO_LOG_FRAGMENT_HEADER_SIZE];
+            const char *newline = memchr(bytes + position, '\n', MIN(length - position, sizeof(header)));
+            size_t headerLength = newline ? (size_t)(newline + 1 - (bytes + position)) : 0;
+            if (newline)
+            {
+                memcpy(header, bytes + position, headerLength - 1);
+                header[headerLength - 1] = '\0';
+            }
+            if (newline &&
+                sscanf(header + 1, "%d.%u %u/%u %u", &pid, &sequence, &index, &count, &chunkLength) == 5 &&
+                index < count &&
+                position + headerLength + chunkLength <= length)
+            {
+                NSString *key = WO_STRING(@"%d.%u", pid, sequence);
+                NSMutableArray *fragments = [partial objectForKey:key];
+                if (!fragments)
+                {
+                    fragments = [NSMutableArray arrayWithCapacity:count];
+                    for (unsigned i = 0; i < count; i++)
+                        [fragments addObject:[NSNull null]];
+                    [partial setObject:fragments forKey:key];
+                }
+                if (index < [fragments count])
+                    [fragments replaceObjectAtIndex:index
+                                         withObject:[data subdataWithRange:NSMakeRange(position + headerLength, chunkLength)]];
+                if (![fragments containsObject:[NSNull null]])
+                {
+                    for (NSData *fragment in fragments)
+                        [result appendData:fragment];
+                    [partial removeObjectForKey:key];
+                }
+                position += headerLength + chunkLength;
+                continue;
+            }
+        }
+
+        // plain record (or malformed frame): copy through the end of the line
+        const char *newline = memchr(bytes + position, '\n', length - position);
+        size_t end = newline ? (size_t)(newline + 1 - bytes) : length;
+        [result appendBytes:bytes + position length:end - position];
+        position = end;
+    }
+    return result;
+}
+
+@synthesize path;
+
+@end
@@ -0,0 +1,133 @@
+// WOLogFlightRecorder.h
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// superclass header
+#import "WOObject.h"
+
+//! Magic number at the start of every flight recorder file ("WOFR").
+#define WO_LOG_FLIGHT_RECORDER_MAGIC    0x57464f52
+
+#define WO_LOG_FLIGHT_RECORDER_VERSION  1
+
+//! Default size in bytes of the record area of a flight recorder file.
+#define WO_LOG_FLIGHT_RECORDER_DEFAULT_CAPACITY (4 * 1024 * 1024)
+
+//! Records longer than this many bytes are truncated.
+#define WO_LOG_FLIGHT_RECORDER_MAXIMUM_RECORD 4096
+
+//! Layout of the first page of a flight recorder file. All integers are in
+//! host byte order.
+typedef struct WOLogFlightRecorderHeader {
+
+    uint32_t            magic;
+    uint32_t            version;
+
+    //! Size of the record area (which starts one page into the file) in
+    //! bytes; always a power of two.
+    uint64_t            capacity;
+
+    //! Total number of bytes ever reserved by writers; records occupy the
+    //! range [head - capacity, head) of this ever-increasing offset, modulo
+    //! the capacity.
+    volatile int64_t    head;
+
+    //! Process which created the file.
+    int32_t             pid;
+
+} WOLogFlightRecorderHeader;
+
+//! Frame preceding each record in the record area. Frames are 8-byte aligned.
+//!
+//! A writer reserves space with a single atomic add on the header's \c head,
+//! copies in the record, and only then stores \c position (the absolute
+//! offset of the frame), which serves as the commit marker: a frame whose
+//! stored position does not match its actual position is either incomplete or
+//! left over from an earlier lap around the ring, and readers skip it.
+typedef struct WOLogFlightRecorderFrame {
+
+    volatile int64_t    position;
+    uint32_t            length;
+    uint32_t            level;
+
+} WOLogFlightRecorderFrame;
+
+//! Always-on, crash-surviving record of recent log messages.
+//!
+//! Records are copied into a fixed-size ring inside a file-backed shared
+//! memory mapping. Writing a record is an atomic add and a memcpy(): no
+//! system calls are made, and because the mapping is shared the kernel
+//! retains the data (and eventually writes it back to the file) even if the
+//! process crashes. The recent window can then be extracted from the file
+//! with #recordsInFile:.
+//!
+//! See WOLogManager::flightRecorder.
+@interface WOLogFlightRecorder : WOObject {
+
+    NSString                    *path;
+    WOLogFlightRecorderHeader   *header;
+    char                        *records;
+    size_t                      mappingSize;
+
+}
+
+//! Designated initializer. Creates the file at \p aPath and maps it.
+//! \p aCapacity is rounded up to a power of two. Returns nil if the file
+//! could not be created or mapped.
+//!
+//! An existing file at \p aPath (typically the recording of a process which
+//! crashed) is never overwritten: it is first moved aside to the path
+//! returned by #previousPathForPath:, replacing any older recording there, so
+//! that it can still be recovered with #recordsInFile:. Returns nil if the
+//! existing file could not be moved aside.
+//!
+//! \throws NSInternalInconsistencyException Throws an exception if \p aPath is
+//! nil.
+- (id)initWithPath:(NSString *)aPath capacity:(size_t)aCapacity;
+
+//! Copies \p length bytes into the ring. Thread-safe and lock-free.
+- (void)recordBytes:(const void *)bytes length:(size_t)length level:(unsigned)level;
+
+//! Returns the records which are still intact in the ring, oldest first, as
+//! WOLogRecord objects. Records being written concurrently are skipped.
+- (NSArray *)records;
+
+//! Returns the records in the flight recorder file at \p aPath, oldest first,
+//! as WOLogRecord objects; this is how the recent window is recovered after a
+//! crash. Returns nil if the file cannot be read or is not a flight recorder
+//! file.
++ (NSArray *)recordsInFile:(NSString *)aPath;
+
+//! Returns the path to which an existing recording at \p aPath is moved when
+//! a new flight recorder is created there: \p aPath with ".previous"
+//! appended.
+//!
+//! \throws NSInternalInconsistencyException Throws an exception if \p aPath is
+//! nil.
++ (NSString *)previousPathForPath:(NSString *)aPath;
+
+@property(readonly, copy) NSString *path;
+
+@end
@@ -0,0 +1,215 @@
+// WOLogFlightRecorder.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOLogFlightRecorder.h"
+
+// system headers
+#import <errno.h>               /* errno, ENOENT */
+#import <fcntl.h>               /* open() */
+#import <libkern/OSAtomic.h>    /* OSAtomicAdd64Barrier() */
+#import <stdio.h>               /* rename() */
+#import <sys/mman.h>            /* mmap(), munmap() */
+#import <unistd.h>              /* ftruncate(), close(), getpagesize() */
+
+// other headers
+#import "WOLogSink.h"           /* WOLogRecord */
+#import "WOMemoryBarrier.h"
+
+// macro headers
+#import "WODebugMacros.h"
+
+#pragma mark -
+#pragma mark Functions
+
+static inline int64_t WOLogFlightRecorderAlign(int64_t value)
+{
+    return (value + 7) & ~(int64_t)7;
+}
+
+//! Copies \p length bytes into the ring starting at absolute \p offset,
+//! wrapping around the end if necessary.
+static void WOLogFlightRecorderCopyIn(char *ring, uint64_t capacity, int64_t offset, const void *bytes, size_t length)
+{
+    size_t start = (size_t)(offset & (capacity - 1));
+    size_t first = MIN(length, (size_t)capacity - start);
+    memcpy(ring + start, bytes, first);
+    if (first < length)
+        memcpy(ring, (const char *)bytes + first, length - first);
+}
+
+static void WOLogFlightRecorderCopyOut(const char *ring, uint64_t capacity, int64_t offset, void *bytes, size_t length)
+{
+    size_t start = (size_t)(offset & (capacity - 1));
+    size_t first = MIN(length, (size_t)capacity - start);
+    memcpy(bytes, ring + start, first);
+    if (first < length)
+        memcpy((char *)bytes + first, ring, length - first);
+}
+
+//! Walks the ring from the oldest possible frame to \p head, collecting
+//! committed records and resynchronizing on 8-byte boundaries past anything
+//! which is incomplete or overwritten.
+static NSArray *WOLogFlightRecorderCollect(const char *ring, uint64_t capacity, int64_t head)
+{
+    NSMutableArray *collected = [NSMutableArray array];
+    int64_t position = head > (int64_t)capacity ? head - (int64_t)capacity : 0;
+    while (position + (int64_t)sizeof(WOLogFlightRecorderFrame) <= head)
+    {
+        WOLogFlightRecorderFrame frame;
+        WOLogFlightRecorderCopyOut(ring, capacity, position, &frame, sizeof(frame));
+        WO_READ_MEMORY_BARRIER();   // read commit marker before the contents
+        int64_t size = WOLogFlightRecorderAlign(sizeof(frame) + frame.length);
+        if (frame.position != position || frame.length > WO_LOG_FLIGHT_RECORDER_MAXIMUM_RECORD ||
+            position + size > head)
+        {
+            position += 8;
+            continue;
+        }
+        NSMutableData *data = [NSMutableData dataWithLength:frame.length];
+        WOLogFlightRecorderCopyOut(ring, capacity, position + sizeof(frame), [data mutableBytes], frame.length);
+
+        // a live writer may have lapped us while copying
+        WOLogFlightRecorderFrame check;
+        WO_READ_MEMORY_BARRIER();
+        WOLogFlightRecorderCopyOut(ring, capacity, position, &check, sizeof(check));
+        if (check.position == position)
+            [collected addObject:[[WOLogRecord alloc] initWithData:data level:frame.level]];
+        position += size;
+    }
+    return collected;
+}
+
+@implementation WOLogFlightRecorder
+
+- (id)initWithPath:(NSString *)aPath capacity:(size_t)aCapacity
+{
+    WOParameterCheck(aPath != nil);
+    if ((self = [super init]))
+    {
+        path = [aPath copy];
+        uint64_t capacity = 4096;
+        while (capacity < aCapacity)
+            capacity <<= 1;
+        size_t pageSize = (size_t)getpagesize();
+        mappingSize = pageSize + (size_t)capacity;
+
+        // preserve the last recording (perhaps of a crash) rather than wiping it
+        NSString *previous = [[self class] previousPathForPath:path];
+        if (rename([path fileSystemRepresentation], [previous fileSystemRepresentation]) != 0 && errno != ENOENT)
+        {
+            NSLog(@"error: rename() (errno = %d) for flight recorder \"%@\"", errno, path);
+            return nil;
+        }
+
+        int descriptor = open([path fileSystemRepresentation], O_CREAT | O_RDWR, 0600);
+        if (descriptor < 0)
+        {
+            NSLog(@"error: open() (errno = %d) for flight recorder \"%@\"", errno, path);
+            return nil;
+        }
+        if (ftruncate(descriptor, (off_t)mappingSize) != 0)
+        {
+            NSLog(@"error: ftruncate() (errno = %d) for flight recorder \"%@\"", errno, path);
+            close(descriptor);
+            return nil;
+        }
+        void *mapping = mmap(NULL, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        close(descriptor);  // the mapping keeps the file referenced
+        if (mapping == MAP_FAILED)
+        {
+            NSLog(@"error: mmap() (errno = %d) for flight recorder \"%@\"", errno, path);
+            return nil;
+        }
+
+        header              = mapping;
+        records             = (char *)mapping + pageSize;
+        header->capacity    = capacity;
+        header->head        = 0;
+        header->pid         = getpid();
+        header->version     = WO_LOG_FLIGHT_RECORDER_VERSION;
+        WO_WRITE_MEMORY_BARRIER();
+        header->magic       = WO_LOG_FLIGHT_RECORDER_MAGIC;
+    }
+    return self;
+}
+
+- (void)finalize
+{
+    if (header)
+        munmap(header, mappingSize);
+    [super finalize];
+}
+
+- (void)recordBytes:(const void *)bytes length:(size_t)length level:(unsigned)level
+{
+    if (length > WO_LOG_FLIGHT_RECORDER_MAXIMUM_RECORD)
+        length = WO_LOG_FLIGHT_RECORDER_MAXIMUM_RECORD;
+    int64_t size = WOLogFlightRecorderAlign(sizeof(WOLogFlightRecorderFrame) + length);
+    int64_t position = OSAtomicAdd64Barrier(size, &header->head) - size;
+
+    WOLogFlightRecorderFrame frame = { .position = -1, .length = (uint32_t)length, .level = level };
+    WOLogFlightRecorderCopyIn(records, header->capacity, position, &frame, sizeof(frame));
+    WOLogFlightRecorderCopyIn(records, header->capacity, position + sizeof(frame), bytes, length);
+
+    // commit: the position field is the first (8-byte aligned) word of the
+    // frame, so it never straddles the end of the ring
+    WO_WRITE_MEMORY_BARRIER();
+    ((WOLogFlightRecorderFrame *)(records + (position & (header->capacity - 1))))->position = position;
+}
+
+- (NSArray *)records
+{
+    int64_t head = header->head;
+    WO_READ_MEMORY_BARRIER();
+    return WOLogFlightRecorderCollect(records, header->capacity, head);
+}
+
++ (NSArray *)recordsInFile:(NSString *)aPath
+{
+    WOParameterCheck(aPath != nil);
+    NSData *data = [NSData dataWithContentsOfFile:aPath options:NSDataReadingMapped error:NULL];
+    size_t pageSize = (size_t)getpagesize();
+    if (!data || [data length] < pageSize)
+        return nil;
+    const WOLogFlightRecorderHeader *fileHeader = [data bytes];
+    if (fileHeader->magic != WO_LOG_FLIGHT_RECORDER_MAGIC ||
+        fileHeader->version != WO_LOG_FLIGHT_RECORDER_VERSION ||
+        fileHeader->capacity == 0 || (fileHeader->capacity & (fileHeader->capacity - 1)) != 0 ||
+        [data length] < pageSize + fileHeader->capacity)
+        return nil;
+    return WOLogFlightRecorderCollect((const char *)[data bytes] + pageSize, fileHeader->capacity, fileHeader->head);
+}
+
++ (NSString *)previousPathForPath:(NSString *)aPath
+{
+    WOParameterCheck(aPath != nil);
+    return [aPath stringByAppendingString:@".previous"];
+}
+
+@synthesize path;
+
+@end
@@ -27,38 +27,333 @@
 // superclass header
 #import "WOObject.h"
 
+// system headers
+#import <asl.h>                 /* ASL_LEVEL_DEBUG */
+#import <dispatch/dispatch.h>   /* dispatch_source_t */
+#import <objc/runtime.h>        /* class_getName() */
+
+// other headers
+#import "WOLogFileSink.h"
+#import "WOLogRingBuffer.h"
+#import "WOLogSink.h"
+#import "WOLogSyncer.h"
+#import "WOLogFlightRecorder.h"
+
 #pragma mark -
 #pragma mark Macros
 
 #ifdef WO_DEBUG
 
-//! Convenience macro that invokes the #WOLogManager::log: method to log
-//! information about class name, method name, file name and line number
-//! (useful for debugging). In debug builds the filename and line number is
-//! included.
+//! Convenience macro that logs information about class name, method name, file
+//! name and line number (useful for debugging) at ASL_LEVEL_DEBUG. The message
+//! is logged through a precompiled call-site descriptor (see WO_LOG_SITE), so
+//! when debug messages are disabled the macro costs only a load and a branch.
+//! In debug builds the filename and line number is included.
+#define WO_LOG_METHOD_DETAILS                                               \
+    _WO_LOG_SITE(WO_LOG_DEFAULT_CATEGORY, WO_LOG_SITE_APPENDS_LOCATION,     \
+        ASL_LEVEL_DEBUG, "",                                                \
+        "%c[%s %s]", ((void *)[self class] == (void *)self ? '+' : '-'),    \
+        class_getName([self class]), sel_getName(_cmd))
+
+#else /* Release configuration: no file and line information included */
+
+//! Convenience macro that logs information about class name, method name, file
+//! name and line number (useful for debugging) at ASL_LEVEL_DEBUG. The message
+//! is logged through a precompiled call-site descriptor (see WO_LOG_SITE), so
+//! when debug messages are disabled the macro costs only a load and a branch.
+//! In non-debug builds the filename and line number is omitted.
 #define WO_LOG_METHOD_DETAILS                                               \
+    _WO_LOG_SITE(WO_LOG_DEFAULT_CATEGORY, 0, ASL_LEVEL_DEBUG, "",           \
+        "%c[%s %s]", ((void *)[self class] == (void *)self ? '+' : '-'),    \
+        class_getName([self class]), sel_getName(_cmd))
+
+#endif
+
+//! Convenience macro that logs to the category identified by \p category
+//! (see WOLogManager::registerCategory:) at the given \p level. The level
+//! check is performed inline before any of the format arguments are evaluated,
+//! so disabled call sites cost only a load from WOLogCategoryLevels and a
+//! branch.
+//!
+//! \code
+//! static WOLogCategory net;
+//! net = [WOLog registerCategory:@"net"];
+//! WO_LOG_CATEGORY(net, ASL_LEVEL_DEBUG, @"received %lu bytes", length);
+//! \endcode
+#define WO_LOG_CATEGORY(category, level, ...)                               \
 do                                                                          \
 {                                                                           \
-    [WOLog logDebug:@"%@[%@ %@] (%s:%d)",                                   \
-        ((void *)[self class] == (void *)self ? @"+" : @"-"),               \
-        [self class], NSStringFromSelector(_cmd), __FILE__, __LINE__];      \
+    if (WOLogCategoryEnabled((category), (level)))                          \
+        [WOLog logCategory:(category) level:(level) message:__VA_ARGS__];   \
 } while (0)
 
-#else /* Release configuration: no file and line information included */
+#pragma mark -
+#pragma mark Log categories
+
+//! Maximum number of distinct log categories that can be registered with
+//! WOLogManager::registerCategory:.
+#define WO_LOG_MAX_CATEGORIES 64
+
+//! Handle returned by WOLogManager::registerCategory:. Handles are small
+//! integers which index directly into the WOLogCategoryLevels table.
+typedef unsigned WOLogCategory;
+
+//! The handle of the default category, which is always registered and whose
+//! level always mirrors the WOLogManager::logLevel property.
+#define WO_LOG_DEFAULT_CATEGORY ((WOLogCategory)0)
+
+//! Table of per-category log levels, indexed by WOLogCategory handle. The
+//! table is exported only so that WOLogCategoryEnabled can be inlined; it
+//! should be modified using WOLogManager::setLevel:forCategory: and never
+//! written to directly.
+extern volatile unsigned WOLogCategoryLevels[WO_LOG_MAX_CATEGORIES];
+
+//! Level down to which messages are formatted regardless of category levels
+//! so that they can be captured by the flight recorder: ASL_LEVEL_DEBUG while
+//! WOLogManager::flightRecorder is set, otherwise 0 (which never widens the
+//! category check). Exported only for WOLogCategoryEnabled.
+extern volatile unsigned WOLogFlightRecorderLevel;
+
+//! Returns YES if a message of \p level would be logged to \p category (or
+//! captured by the flight recorder).
+WO_INLINE BOOL WOLogCategoryEnabled(WOLogCategory category, unsigned level)
+{
+    return level <= WOLogCategoryLevels[category] || level <= WOLogFlightRecorderLevel;
+}
 
-//! Convenience macro that invokes the #WOLogManager::log: method to log
-//! information about class name, method name, file name and line number
-//! (useful for debugging). In non-debug builds the filename and line number is
-//! omitted.
-#define WO_LOG_METHOD_DETAILS                                               \
+#pragma mark -
+#pragma mark Throttled logging
+
+//! Per-call-site state for sampled and rate-limited logging. One of these is
+//! declared statically at each call site by the WO_LOG_SAMPLED and
+//! WO_LOG_RATE_LIMITED macros; the mutable fields are only ever modified using
+//! atomic operations, so call sites may be hit concurrently from any number of
+//! threads without locking.
+//!
+//! Dropped messages are counted and periodically reported by the shared
+//! WOLogManager in a single "suppressed N similar messages" line per site (see
+//! WOLogManager::suppressionSummaryInterval).
+typedef struct WOLogThrottle {
+
+    const char                      *file;
+    int                             line;
+
+    //! For sampled sites, one in every \c interval messages is logged.
+    int64_t                         interval;
+
+    //! For rate-limited sites, the number of nanoseconds which must elapse for
+    //! a token to be added to the bucket (that is, one second divided by the
+    //! rate).
+    int64_t                         emissionInterval;
+
+    //! For rate-limited sites, how far ahead of the present the bucket's
+    //! theoretical arrival time may run before messages are dropped (that is,
+    //! the emission interval multiplied by one less than the burst size).
+    int64_t                         tolerance;
+
+    //! Number of messages seen (sampled sites) or the theoretical arrival time
+    //! of the next token in nanoseconds (rate-limited sites).
+    volatile int64_t                state;
+
+    //! Messages dropped since the last summary.
+    volatile int32_t                suppressed;
+
+    //! Level of the most recently dropped message; used for the summary.
+    volatile int32_t                level;
+
+    //! Non-zero once the site has been added to the summary list.
+    volatile int32_t                registered;
+
+    struct WOLogThrottle * volatile next;
+
+} WOLogThrottle;
+
+//! Initializer for a WOLogThrottle which logs one in every \p n messages.
+#define WO_LOG_THROTTLE_SAMPLED(n) \
+    { .file = __FILE__, .line = __LINE__, .interval = (n) }
+
+//! Initializer for a WOLogThrottle which logs at most \p rate messages per
+//! second on average, with bursts of up to \p burst messages.
+#define WO_LOG_THROTTLE_RATE_LIMITED(rate, burst)                           \
+    { .file = __FILE__, .line = __LINE__,                                   \
+      .emissionInterval = 1000000000LL / (rate),                            \
+      .tolerance = (1000000000LL / (rate)) * ((burst) - 1) }
+
+//! Returns YES if the message at a sampled call site should be logged. The
+//! first message is always logged.
+BOOL WOLogThrottleSample(WOLogThrottle *throttle, unsigned level);
+
+//! Returns YES if the message at a rate-limited call site should be logged.
+//!
+//! The token bucket is implemented using the equivalent "generic cell rate
+//! algorithm", in which the entire bucket state is a single 64-bit timestamp
+//! that can be advanced with one compare-and-swap.
+BOOL WOLogThrottleAcquire(WOLogThrottle *throttle, unsigned level);
+
+//! Logs one in every \p n messages passing through the call site. \p n must
+//! be a compile-time constant.
+//!
+//! \code
+//! WO_LOG_SAMPLED(1000, ASL_LEVEL_ERR, @"read failed: %d", errno);
+//! \endcode
+#define WO_LOG_SAMPLED(n, level, ...)                                       \
 do                                                                          \
 {                                                                           \
-    [WOLog logDebug:@"%@[%@ %@]",                                           \
-        ((void *)[self class] == (void *)self ? @"+" : @"-"),               \
-        [self class], NSStringFromSelector(_cmd)];                          \
+    static WOLogThrottle _WOLogThrottle = WO_LOG_THROTTLE_SAMPLED(n);       \
+    if (WOLogCategoryEnabled(WO_LOG_DEFAULT_CATEGORY, (level)) &&           \
+        WOLogThrottleSample(&_WOLogThrottle, (level)))                      \
+        [WOLog logLevel:(level) message:__VA_ARGS__];                       \
 } while (0)
 
-#endif
+//! Logs at most \p rate messages per second (with bursts of up to \p burst
+//! messages) passing through the call site. \p rate and \p burst must be
+//! compile-time constants.
+//!
+//! \code
+//! WO_LOG_RATE_LIMITED(10, 50, ASL_LEVEL_ERR, @"dropped packet from %@", peer);
+//! \endcode
+#define WO_LOG_RATE_LIMITED(rate, burst, level, ...)                        \
+do                                                                          \
+{                                                                           \
+    static WOLogThrottle _WOLogThrottle =                                   \
+        WO_LOG_THROTTLE_RATE_LIMITED(rate, burst);                          \
+    if (WOLogCategoryEnabled(WO_LOG_DEFAULT_CATEGORY, (level)) &&           \
+        WOLogThrottleAcquire(&_WOLogThrottle, (level)))                     \
+        [WOLog logLevel:(level) message:__VA_ARGS__];                       \
+} while (0)
+
+#pragma mark -
+#pragma mark Call-site descriptors
+
+//! Set in WOLogSite::state while messages from the site would be logged; this
+//! is the only bit tested at the call site. Sites start out with this bit set
+//! so that their first invocation reaches WOLogSiteEmit, which registers the
+//! site and computes the real value.
+#define WO_LOG_SITE_ENABLED             0x1
+
+//! Set in WOLogSite::state once the site has been registered.
+#define WO_LOG_SITE_REGISTERED          0x2
+
+//! Set in WOLogSite::state while the site has been switched off at runtime
+//! (see WOLogManager::setEnabled:forLogSitesInFile:line:).
+#define WO_LOG_SITE_SWITCHED_OFF        0x4
+
+//! Set in WOLogSite::state if " (file:line)" should be appended to messages.
+#define WO_LOG_SITE_APPENDS_LOCATION    0x8
+
+//! Parsed form of a call site's format string; private to WOLogManager.
+struct WOLogSiteLayout;
+
+//! Static descriptor for a single logging call site, declared by the
+//! WO_LOG_SITE family of macros. Everything which does not vary from call to
+//! call is worked out once: the message prefix is joined to the format string
+//! by the compiler, and the format string is parsed into a WOLogSiteLayout the
+//! first time the site is reached. Thereafter enabled sites format their
+//! arguments directly from the layout without building or re-parsing any
+//! format strings, and disabled sites are skipped after a single load and
+//! branch on #state, which the shared WOLogManager recomputes whenever levels
+//! change.
+typedef struct WOLogSite {
+
+    const char                  *file;
+    int                         line;
+    unsigned                    level;
+
+    //! The prefix and the format, joined at compile time. As well as the usual
+    //! printf conversions the format may contain \c %@ for objects, which are
+    //! formatted using WOLogManager::stringForObject:.
+    const char                  *format;
+
+    //! WO_LOG_SITE_* flags.
+    volatile uint32_t           state;
+
+    //! Category whose level (see WOLogManager::setLevel:forCategory:) decides
+    //! whether the site is enabled; set from the WO_LOG_SITE_CATEGORY
+    //! argument when the site is first reached, and WO_LOG_DEFAULT_CATEGORY
+    //! for the other WO_LOG_SITE macros.
+    WOLogCategory               category;
+
+    //! Set when the site is registered.
+    struct WOLogSiteLayout      *layout;
+
+    struct WOLogSite            *next;
+
+} WOLogSite;
+
+//! Registers \p site if necessary and, if it is still enabled, formats the
+//! arguments and logs the message. Invoked by the WO_LOG_SITE macros, and only
+//! when WO_LOG_SITE_ENABLED is set.
+void WOLogSiteEmit(WOLogSite *site, ...);
+
+//! Private macro underlying the WO_LOG_SITE family; \p format and \p prefix
+//! must be C string literals. Category handles are only known at run time, so
+//! \p cat is stored until the site has been registered rather than in the
+//! static initializer.
+#define _WO_LOG_SITE(cat, flags, lvl, prefix, fmt, ...)                     \
+do                                                                          \
+{                                                                           \
+    static WOLogSite _WOLogSite = {                                         \
+        .file = __FILE__, .line = __LINE__, .level = (lvl),                 \
+        .format = prefix fmt, .state = WO_LOG_SITE_ENABLED | (flags) };     \
+    if (_WOLogSite.state & WO_LOG_SITE_ENABLED)                             \
+    {                                                                       \
+        if (!(_WOLogSite.state & WO_LOG_SITE_REGISTERED))                   \
+            _WOLogSite.category = (cat);                                    \
+        WOLogSiteEmit(&_WOLogSite, ##__VA_ARGS__);                          \
+    }                                                                       \
+} while (0)
+
+//! Logs at \p level through a static call-site descriptor (see WOLogSite).
+//! \p format must be a C string literal, which may contain \c %@ (without
+//! flags, width or precision).
+//!
+//! \code
+//! WO_LOG_SITE(ASL_LEVEL_INFO, "accepted %@ (%d pending)", peer, pending);
+//! \endcode
+#define WO_LOG_SITE(level, format, ...) \
+    _WO_LOG_SITE(WO_LOG_DEFAULT_CATEGORY, 0, level, "", format, ##__VA_ARGS__)
+
+//! Like WO_LOG_SITE, but prefixes the message with
+//! WO_LOG_WARNING_PREFIX_UTF8.
+#define WO_LOG_SITE_WARNING(level, format, ...) \
+    _WO_LOG_SITE(WO_LOG_DEFAULT_CATEGORY, 0, level, WO_LOG_WARNING_PREFIX_UTF8, format, ##__VA_ARGS__)
+
+//! Like WO_LOG_SITE, but prefixes the message with WO_LOG_ERROR_PREFIX_UTF8.
+#define WO_LOG_SITE_ERROR(level, format, ...) \
+    _WO_LOG_SITE(WO_LOG_DEFAULT_CATEGORY, 0, level, WO_LOG_ERROR_PREFIX_UTF8, format, ##__VA_ARGS__)
+
+//! Equivalent to WO_LOG_SITE at ASL_LEVEL_DEBUG; the call-site replacement
+//! for WOLogManager::logDebug:.
+#define WO_LOG_SITE_DEBUG(format, ...) \
+    _WO_LOG_SITE(WO_LOG_DEFAULT_CATEGORY, 0, ASL_LEVEL_DEBUG, "", format, ##__VA_ARGS__)
+
+//! Like WO_LOG_SITE, but enabled according to the level of \p category (a
+//! handle returned by WOLogManager::registerCategory:), whose name prefixes
+//! the message as for WOLogManager::logCategory:level:message:. \p category
+//! is evaluated only until the site has been registered, so it must not vary
+//! between invocations.
+#define WO_LOG_SITE_CATEGORY(category, level, format, ...) \
+    _WO_LOG_SITE(category, 0, level, "", format, ##__VA_ARGS__)
+
+#pragma mark -
+#pragma mark Durability
+
+//! Values for the WOLogManager::durability property.
+typedef enum WOLogDurability {
+
+    //! Log data reaches the disk whenever the operating system writes it back.
+    WOLogDurabilityNone         = 0,
+
+    //! The log file is synced every WOLogManager::durabilityInterval seconds
+    //! if anything has been written to it since the last sync.
+    WOLogDurabilityPeriodic     = 1,
+
+    //! Logging a message to file does not return until the message is on
+    //! stable storage; concurrent callers share syncs (see WOLogSyncer). When
+    //! logging asynchronously the writer thread syncs after each batch.
+    WOLogDurabilityGroupCommit  = 2
+
+} WOLogDurability;
 
 //! Required classes:
 //!
@@ -81,6 +376,58 @@ do                                                                          \
     NSString    *defaultLogFilePath;
     BOOL        logsToFileByDefault;
 
+    //! Registered category names, indexed by WOLogCategory handle.
+    NSMutableArray      *categoryNames;
+
+    //! Levels requested (by name) for categories which have not yet been
+    //! registered; applied at registration time.
+    NSMutableDictionary *pendingCategoryLevels;
+
+    NSString            *categoryLevelsPath;
+
+    //! Dispatch sources installed by #reloadCategoryLevelsOnSignal:.
+    NSMutableArray      *signalSources;
+
+    NSTimeInterval      suppressionSummaryInterval;
+
+    //! Timer which periodically invokes #logSuppressionSummaries.
+    dispatch_source_t   suppressionSummaryTimer;
+
+    BOOL                logsAsynchronously;
+
+    //! Records waiting to be written by the writer thread; created the first
+    //! time #logsAsynchronously is set.
+    WOLogRingBuffer     *ringBuffer;
+
+    //! UTF-8 copy of #processName for formatting record headers without
+    //! allocating.
+    char                processNameBuffer[64];
+
+    //! Immutable; replaced wholesale by #addSink: and #removeSink: so that
+    //! logging threads can read it without locking.
+    NSArray             *sinks;
+
+    WOLogFlightRecorder *flightRecorder;
+
+    BOOL                logsToSharedFile;
+
+    //! Writer for #logsToSharedFile; replaced (not modified) when the log file
+    //! path changes.
+    WOLogFileSink       *sharedFileSink;
+
+    //! Call-site switches set with #setEnabled:forLogSitesInFile:line:, in
+    //! order; each is an array of file name, line number and flag.
+    NSMutableArray      *logSiteSwitches;
+
+    WOLogDurability     durability;
+    NSTimeInterval      durabilityInterval;
+
+    //! Syncer for the current log file; replaced when the path changes.
+    WOLogSyncer         *syncer;
+
+    //! Timer which syncs the log file in WOLogDurabilityPeriodic mode.
+    dispatch_source_t   durabilityTimer;
+
 }
 
 #pragma mark -
@@ -105,6 +452,16 @@ do                                                                          \
 //! non-NSString format string is passed.
 - (void)vLogToFileLevel:(unsigned)level message:(NSString *)format args:(va_list)args;
 
+//! This is a primitive logging method which logs an already formatted
+//! message to \p category, applying the category level and the
+//! #flightRecorder exactly as the other logging methods do. It is used by
+//! WOLogSiteEmit; rather than calling this method you should call one of the
+//! methods in the "Logging methods" group.
+//!
+//! \throws NSInternalInconsistencyException Throws an exception if \p message
+//! is nil.
+- (void)logCategory:(WOLogCategory)category level:(unsigned)level formattedMessage:(NSString *)message;
+
 //! This is a primitive logging method which unconditionally logs to standard
 //! error (in other words, it ignores the logsToFileByDefault setting). Rather
 //! than calling this method you should call one of the methods in the "Logging
@@ -201,6 +558,160 @@ do                                                                          \
 
 //@}
 
+#pragma mark -
+#pragma mark Category methods
+
+//! \name Category methods
+//!
+//! Categories allow individual subsystems to be given their own log level so
+//! that, for example, debug logging can be turned on for one component without
+//! turning it on for the entire process. Categories are registered once by
+//! name and are identified thereafter by the returned WOLogCategory handle.
+//!
+//! Category levels can be overridden at startup and at runtime using a
+//! specification string of the form "name=level,name=level". The special name
+//! "*" applies to all categories. Specifications are read from the
+//! WO_LOG_CATEGORY_LEVELS_ENVIRONMENT_VARIABLE environment variable and from
+//! the file at #categoryLevelsPath, if set.
+
+//@{
+
+//! Registers a category named \p name and returns its handle. Registering the
+//! same name more than once returns the same handle. The initial level of a
+//! newly registered category is taken from any matching override which has
+//! been applied, or failing that from the #logLevel property.
+//!
+//! \throws NSInternalInconsistencyException Throws an exception if \p name is
+//! nil.
+//! \throws NSRangeException Throws an exception if WO_LOG_MAX_CATEGORIES
+//! categories have already been registered.
+- (WOLogCategory)registerCategory:(NSString *)name;
+
+//! Returns the name under which \p category was registered, or nil if no such
+//! category has been registered.
+- (NSString *)nameForCategory:(WOLogCategory)category;
+
+- (unsigned)levelForCategory:(WOLogCategory)category;
+
+//! Changes the level of \p category. Takes effect immediately for all
+//! threads.
+- (void)setLevel:(unsigned)level forCategory:(WOLogCategory)category;
+
+//! Changes the level of the category named \p name, or if the category has
+//! not yet been registered, records the level so that it can be applied on
+//! registration. The name "*" changes the level of all categories.
+- (void)setLevel:(unsigned)level forCategoryNamed:(NSString *)name;
+
+//! Applies a specification of the form "name=level,name=level"; entries may
+//! be separated by commas, whitespace or newlines. Malformed entries are
+//! logged and skipped.
+- (void)applyCategoryLevels:(NSString *)specification;
+
+//! Re-applies category levels from the environment and from the file at
+//! #categoryLevelsPath (in that order, so that the file takes precedence).
+- (void)reloadCategoryLevels;
+
+//! Arranges for #reloadCategoryLevels to be invoked whenever the process
+//! receives \p signalNumber (for example, SIGHUP). The signal's default action
+//! is set to SIG_IGN and the reload is performed on a dispatch queue, not in
+//! signal handler context.
+- (void)reloadCategoryLevelsOnSignal:(int)signalNumber;
+
+- (void)logCategory:(WOLogCategory)category level:(unsigned)level message:(NSString *)format, ...;
+- (void)logCategory:(WOLogCategory)category level:(unsigned)level warning:(NSString *)format, ...;
+- (void)logCategory:(WOLogCategory)category level:(unsigned)level error:(NSString *)format, ...;
+
+//@}
+
+#pragma mark -
+#pragma mark Sink methods
+
+//! \name Sink methods
+//!
+//! By default messages are written either to the log file or to the standard
+//! error (see #logsToFileByDefault and the "ToFile" logging methods). Once one
+//! or more sinks have been added, every message which passes the #logLevel
+//! check is instead formatted exactly once into a WOLogRecord and submitted to
+//! each sink, which applies its own WOLogSink::minimumLevel. To have a sink
+//! receive more verbose messages than the others, set #logLevel to the most
+//! verbose level required by any sink: #logLevel (and the category levels) is
+//! a floor which WOLogSink::minimumLevel cannot lower, because messages above
+//! it are discarded before they are formatted, without consulting the sinks.
+//!
+//! Sinks write on their own queues and never block the logging thread or
+//! each other (see WOLogSink).
+
+//@{
+
+//! \throws NSInternalInconsistencyException Throws an exception if \p sink is
+//! nil.
+- (void)addSink:(WOLogSink *)sink;
+
+- (void)removeSink:(WOLogSink *)sink;
+
+//! Returns the installed sinks.
+- (NSArray *)sinks;
+
+//@}
+
+#pragma mark -
+#pragma mark Asynchronous logging methods
+
+//! Blocks until every record logged to file (by any thread) before the call
+//! has been written out by the writer thread. Returns immediately if
+//! #logsAsynchronously has never been enabled. Invoked automatically at exit.
+- (void)flush;
+
+//! Returns the total number of records which have been dropped because the
+//! asynchronous ring buffer was full.
+- (int64_t)droppedRecordCount;
+
+#pragma mark -
+#pragma mark Durability methods
+
+//! Blocks until everything logged to file (by any thread) before the call is
+//! on stable storage, whatever the #durability mode; concurrent callers share
+//! syncs. Records queued by asynchronous logging are written out first.
+//! Returns NO if the log file could not be synced.
+- (BOOL)syncLogFile;
+
+//! Returns statistics, including sync latencies, for the syncs performed on
+//! the current log file.
+- (WOLogSyncStatistics)syncStatistics;
+
+#pragma mark -
+#pragma mark Call-site methods
+
+//! Switches the call sites (see WO_LOG_SITE) in \p file on or off at runtime.
+//! \p file may be a full path as given by __FILE__ or just the last path
+//! component. If \p line is 0 all sites in the file are affected, otherwise
+//! only the site on that line. The setting also applies to matching sites
+//! which have not yet been reached. Switched off sites cost a load and a
+//! branch; switching a site on does not override the level checks.
+//!
+//! \throws NSInternalInconsistencyException Throws an exception if \p file is
+//! nil.
+- (void)setEnabled:(BOOL)flag forLogSitesInFile:(NSString *)file line:(int)line;
+
+#pragma mark -
+#pragma mark Flight recorder methods
+
+//! Convenience method which creates a WOLogFlightRecorder at \p path with the
+//! default capacity and installs it as the #flightRecorder. The recording left
+//! at \p path by an earlier run is kept (see
+//! WOLogFlightRecorder::initWithPath:capacity:). Returns NO if the recorder
+//! could not be created.
+- (BOOL)startFlightRecorderAtPath:(NSString *)path;
+
+#pragma mark -
+#pragma mark Throttling methods
+
+//! Logs a "suppressed N similar messages" line for every sampled or
+//! rate-limited call site which has dropped messages since the last summary,
+//! and resets the counts. Normally invoked automatically every
+//! #suppressionSummaryInterval seconds.
+- (void)logSuppressionSummaries;
+
 #pragma mark -
 #pragma mark Utility methods
 
@@ -228,6 +739,9 @@ do                                                                          \
 //! #logToFileLevel:message:, #logToFileLevel:warning: and
 //! #logToFileLevel:error: methods will only produce log output if passed 0 in
 //! the level parameter.
+//!
+//! Also applies to messages sent to sinks, whatever their
+//! WOLogSink::minimumLevel (see #addSink:).
 @property           unsigned    logLevel;
 
 //! When logging to a file the logfile path is automatically determined
@@ -240,6 +754,54 @@ do                                                                          \
 @property(readonly, copy)   NSString    *defaultLogFilePath;
 @property                   BOOL        logsToFileByDefault;
 
+//! When set, every message passed to the receiver is copied into the flight
+//! recorder, at every level and irrespective of #logLevel, category levels and
+//! sinks; messages below the configured levels are recorded but otherwise
+//! discarded as usual. Set to nil to stop recording.
+@property(retain)           WOLogFlightRecorder *flightRecorder;
+
+//! When YES, messages logged to file are formatted by the calling thread
+//! directly into a preallocated slot of a lock-free ring buffer (see
+//! WOLogRingBuffer.h) and written out in order by a dedicated writer thread,
+//! which holds the log file open and batches writes. Logging threads never
+//! contend on the file lock and never block; if the buffer is full the record
+//! is dropped and counted (see #droppedRecordCount), and the writer logs how
+//! many records were lost. Records longer than WO_LOG_RECORD_CAPACITY bytes
+//! are truncated.
+//!
+//! When NO (the default), each message is appended to the log file by the
+//! calling thread under an exclusive lock (unless #logsToSharedFile is set).
+@property                   BOOL        logsAsynchronously;
+
+//! Controls when data logged to file is synced to stable storage (see
+//! WOLogDurability). Applies to all of the ways in which the receiver writes
+//! to the log file, but not to sinks. Defaults to WOLogDurabilityNone.
+@property                   WOLogDurability durability;
+
+//! Interval in seconds between syncs in WOLogDurabilityPeriodic mode.
+//! Defaults to WO_DEFAULT_DURABILITY_INTERVAL.
+@property                   NSTimeInterval  durabilityInterval;
+
+//! Multi-process mode, for use when several processes log to the same file.
+//! When YES, synchronously logged messages are appended without taking the
+//! exclusive file lock: each record is written with a single O_APPEND write()
+//! on a descriptor which is held open, and records longer than
+//! WO_LOG_ATOMIC_APPEND_SIZE are split into framed fragments (see
+//! WOLogFileSink). Use WOLogFileSink::reassembleData: to rejoin fragmented
+//! records when reading the file. Defaults to NO.
+@property                   BOOL        logsToSharedFile;
+
+//! Optional path to a file containing category level overrides in the format
+//! accepted by #applyCategoryLevels:. The file is read when this property is
+//! set and on every subsequent #reloadCategoryLevels.
+@property(copy)             NSString    *categoryLevelsPath;
+
+//! Interval in seconds between automatic invocations of
+//! #logSuppressionSummaries. The timer is only started once a throttled call
+//! site first drops a message. Setting the interval to 0 disables automatic
+//! summaries. Defaults to WO_DEFAULT_SUPPRESSION_SUMMARY_INTERVAL.
+@property                   NSTimeInterval  suppressionSummaryInterval;
+
 @end
 
 #pragma mark -
@@ -282,5 +844,32 @@ do                                                                          \
 //! related methods.
 #define WO_LOG_ERROR_PREFIX @"Error: "
 
+//! C string equivalents of WO_LOG_WARNING_PREFIX and WO_LOG_ERROR_PREFIX, for
+//! joining to call-site format strings at compile time.
+#define WO_LOG_WARNING_PREFIX_UTF8  "Warning: "
+#define WO_LOG_ERROR_PREFIX_UTF8    "Error: "
+
 //! Default log level.
 #define WO_DEFAULT_LOG_LEVEL 5
+
+//! Name of the environment variable from which category level overrides are
+//! read (see WOLogManager::applyCategoryLevels:).
+#define WO_LOG_CATEGORY_LEVELS_ENVIRONMENT_VARIABLE "WO_LOG_CATEGORY_LEVELS"
+
+//! Default value of the WOLogManager::suppressionSummaryInterval property.
+#define WO_DEFAULT_SUPPRESSION_SUMMARY_INTERVAL ((NSTimeInterval)10.0)
+
+//! Default value of the WOLogManager::durabilityInterval property.
+#define WO_DEFAULT_DURABILITY_INTERVAL ((NSTimeInterval)1.0)
+
+//! Number of times a thread logging asynchronously will retry claiming a
+//! ring buffer slot (yielding the processor between attempts) before dropping
+//! its record.
+#define WO_LOG_CLAIM_ATTEMPTS 64
+
+//! Maximum number of records gathered into a single writev() call by the
+//! asynchronous writer thread.
+#define WO_LOG_WRITE_BATCH 64
+
+//! Name under which the WO_LOG_DEFAULT_CATEGORY is registered.
+#define WO_LOG_DEFAULT_CATEGORY_NAME @"default"
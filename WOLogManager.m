@@ -29,6 +29,15 @@
 
 // system headers
 #import <asl.h>
+#import <dispatch/dispatch.h>   /* dispatch_source_create() */
+#import <libkern/OSAtomic.h>    /* OSAtomicCompareAndSwap64Barrier() etc */
+#import <fcntl.h>               /* open() */
+#import <limits.h>              /* PATH_MAX */
+#import <sched.h>               /* sched_yield() */
+#import <signal.h>              /* signal() */
+#import <sys/uio.h>             /* writev() */
+#import <time.h>                /* localtime_r(), strftime() */
+#import <unistd.h>              /* close() */
 
 // category headers
 #import "NSString+WOCreation.h"
@@ -37,19 +46,128 @@
 // macro other headers
 #import "WOConvenienceMacros.h"
 #import "WODebugMacros.h"
+#import "WOMemory.h"
 #import "WOMemoryBarrier.h"
+#import "WOUsageMeter.h"        /* WOMonotonicNanoseconds() */
 
 #pragma mark -
 #pragma mark Global variables
 
 WOLogManager *WOSharedLogManager = nil;
 
+volatile unsigned WOLogCategoryLevels[WO_LOG_MAX_CATEGORIES];
+
+volatile unsigned WOLogFlightRecorderLevel = 0;
+
+//! Head of the list of throttled call sites which have dropped at least one
+//! message; sites are pushed on with compare-and-swap and never removed.
+static WOLogThrottle * volatile WOLogThrottleList = NULL;
+
+//! Head of the list of registered call-site descriptors; only modified (and
+//! the sites' state only changed) while synchronized on the shared manager.
+static WOLogSite *WOLogSiteList = NULL;
+
+//! Maximum number of conversions in a call-site format string; formats with
+//! more are handled by the fallback path.
+#define WO_LOG_SITE_MAX_ARGUMENTS 16
+
+//! Size of the stack buffer into which call-site messages are formatted
+//! (longer messages spill into the heap).
+#define WO_LOG_SITE_BUFFER_SIZE 512
+
+typedef enum WOLogArgumentType {
+
+    WOLogArgumentInt,
+    WOLogArgumentLong,
+    WOLogArgumentLongLong,
+    WOLogArgumentSize,
+    WOLogArgumentPointerDifference,
+    WOLogArgumentIntMax,
+    WOLogArgumentDouble,
+    WOLogArgumentCString,
+    WOLogArgumentPointer,
+    WOLogArgumentObject,
+    WOLogArgumentUnsupported
+
+} WOLogArgumentType;
+
+typedef struct WOLogSiteArgument {
+
+    WOLogArgumentType   type;
+
+    //! Offset into WOLogSiteLayout::literals of the end of the literal text
+    //! preceding this argument.
+    size_t              literalEnd;
+
+    //! Offset into WOLogSiteLayout::specs of this argument's NUL-terminated
+    //! conversion specification (for example, "%-8lu").
+    size_t              spec;
+
+} WOLogSiteArgument;
+
+struct WOLogSiteLayout {
+
+    //! YES if the format uses features not supported by the layout (such as
+    //! positional arguments or "*" widths); it is then handed to NSString each
+    //! time.
+    BOOL                fallback;
+
+    //! The literal text of the format with "%%" collapsed, plus the location
+    //! suffix if any.
+    char                *literals;
+    size_t              literalsLength;
+
+    char                *specs;
+
+    unsigned            argumentCount;
+    WOLogSiteArgument   arguments[WO_LOG_SITE_MAX_ARGUMENTS];
+
+};
+
+static struct WOLogSiteLayout *WOLogSiteParse(WOLogSite *site);
+static BOOL WOLogSiteMatches(WOLogSite *site, const char *file, int line);
+static void WOLogSiteUpdate(WOLogSite *site);
+
+static void WOLogManagerFlushAtExit(void)
+{
+    [WOSharedLogManager flush];
+}
+
+//! Formats a record header resembling "2005-03-24 15:29:32.915 Xcode[17016] "
+//! into \p buffer, returning its length.
+static size_t WOLogFormatHeader(char *buffer, size_t size, const char *processName, int pid)
+{
+    struct timeval now;
+    struct tm local;
+    gettimeofday(&now, NULL);
+    localtime_r(&now.tv_sec, &local);
+    size_t length = strftime(buffer, size, "%Y-%m-%d %H:%M:%S", &local);
+    length += snprintf(buffer + length, size - length, ".%03d %s[%d] ", (int)(now.tv_usec / 1000), processName, pid);
+    return MIN(length, size - 1);
+}
+
 #pragma mark -
 
 @interface WOLogManager ()
 
 @property(copy) NSString    *defaultLogFilePath;
 
+- (void)writeMessageToFile:(NSString *)message level:(unsigned)level;
+- (void)writeMessageToStdErr:(NSString *)message level:(unsigned)level;
+- (BOOL)enqueueMessage:(NSString *)message level:(unsigned)level;
+- (void)recordMessage:(NSString *)message level:(unsigned)level inFlightRecorder:(WOLogFlightRecorder *)recorder;
+- (BOOL)appendMessage:(NSString *)message toSharedFile:(NSString *)path;
+- (WOLogSyncer *)syncerForPath:(NSString *)path;
+- (void)didWriteToLogFile:(NSString *)path;
+- (void)startDurabilityTimer;
+- (void)submitMessage:(NSString *)message level:(unsigned)level toSinks:(NSArray *)someSinks;
+- (void)drainRingBufferInDetachedThread:(id)ignored;
+- (void)vLogCategory:(WOLogCategory)category level:(unsigned)level message:(NSString *)format args:(va_list)args;
+- (void)applyCategoryLevelsFromFile:(NSString *)path;
+- (void)startSuppressionSummaryTimer;
+- (void)registerLogSite:(WOLogSite *)site;
+- (void)refreshLogSites;
+
 @end
 
 // TODO: (for Leopard only?) integration with Apple System Log API (man asl)
@@ -100,6 +218,15 @@ WOLogManager *WOSharedLogManager = nil;
         [self setProcessName:[processInfo processName]];
         [self setProcessIdentifier:[processInfo processIdentifier]];
         [self setLogLevel:WO_DEFAULT_LOG_LEVEL];
+
+        categoryNames = [NSMutableArray arrayWithObject:WO_LOG_DEFAULT_CATEGORY_NAME];
+        pendingCategoryLevels = [NSMutableDictionary dictionary];
+        signalSources = [NSMutableArray array];
+        logSiteSwitches = [NSMutableArray array];
+        [self reloadCategoryLevels];
+
+        suppressionSummaryInterval = WO_DEFAULT_SUPPRESSION_SUMMARY_INTERVAL;
+        durabilityInterval = WO_DEFAULT_DURABILITY_INTERVAL;
     }
     return self;
 }
@@ -111,32 +238,86 @@ WOLogManager *WOSharedLogManager = nil;
 {
     WOParameterCheck([format isKindOfClass:[NSString class]]);
     WOParameterCheck(format != nil);
-    if (level > [self logLevel]) return;
+    WOLogFlightRecorder *recorder = flightRecorder;
+    if (level > [self logLevel] && !recorder) return;
+    NSString *message = [NSString stringWithFormat:format arguments:args];
+    if (recorder)
+    {
+        [self recordMessage:message level:level inFlightRecorder:recorder];
+        if (level > [self logLevel]) return;
+    }
+    [self writeMessageToFile:message level:level];
+}
 
+- (void)vLogToStdErrLevel:(unsigned)level message:(NSString *)format args:(va_list)args
+{
+    WOParameterCheck([format isKindOfClass:[NSString class]]);
+    WOParameterCheck(format != nil);
+    WOLogFlightRecorder *recorder = flightRecorder;
+    if (level > [self logLevel] && !recorder) return;
     NSString *message = [NSString stringWithFormat:format arguments:args];
+    if (recorder)
+    {
+        [self recordMessage:message level:level inFlightRecorder:recorder];
+        if (level > [self logLevel]) return;
+    }
+    [self writeMessageToStdErr:message level:level];
+}
+
+- (void)writeMessageToFile:(NSString *)message level:(unsigned)level
+{
+    NSArray *installedSinks = sinks;
+    WO_READ_MEMORY_BARRIER();
+    if (installedSinks)
+    {
+        [self submitMessage:message level:level toSinks:installedSinks];
+        return;
+    }
+    if (ringBuffer && [self logsAsynchronously])
+    {
+        [self enqueueMessage:message level:level];
+        return;
+    }
+
     NSString *path = [self logFilePath];
     if (!path) path = [self defaultLogFilePath];
 
+    if ([self logsToSharedFile])
+    {
+        if ([self appendMessage:message toSharedFile:path])
+            [self didWriteToLogFile:path];
+        else
+        {
+            NSLog(@"Error: Could not log message to file \"%@\": message follows", path);
+            NSLog(@"%@", message);  // pass string as format argument in case it contains format markers
+        }
+        return;
+    }
+
     NSString *date = [[NSDate date] descriptionWithCalendarFormat:@"%Y-%m-%d %H:%M:%S.%F" timeZone:nil locale:nil];
 
     // Final string should resemble "2005-03-24 15:29:32.915 Xcode[17016] msg"
     NSString *logString = WO_STRING(@"%@ %@[%d] %@\n", date, [self processName], [self processIdentifier], message);
 
-    if (![logString appendToFile:path])
+    if ([logString appendToFile:path])
+        [self didWriteToLogFile:path];
+    else
     {
         NSLog(@"Error: Could not log message to file \"%@\": message follows", path);
         NSLog(@"%@", message);  // pass string as format argument in case it contains format markers
     }
 }
 
-- (void)vLogToStdErrLevel:(unsigned)level message:(NSString *)format args:(va_list)args
+- (void)writeMessageToStdErr:(NSString *)message level:(unsigned)level
 {
-    WOParameterCheck([format isKindOfClass:[NSString class]]);
-    WOParameterCheck(format != nil);
-    if (level > [self logLevel]) return;
-
-    NSString *string = [NSString stringWithFormat:format arguments:args];
-    NSLog(@"%@", string);   // pass string as format argument in case it contains format markers
+    NSArray *installedSinks = sinks;
+    WO_READ_MEMORY_BARRIER();
+    if (installedSinks)
+    {
+        [self submitMessage:message level:level toSinks:installedSinks];
+        return;
+    }
+    NSLog(@"%@", message);  // pass string as format argument in case it contains format markers
 }
 
 #pragma mark -
@@ -459,6 +640,630 @@ WOLogManager *WOSharedLogManager = nil;
     va_end(args);
 }
 
+#pragma mark -
+#pragma mark Category methods
+
+- (WOLogCategory)registerCategory:(NSString *)name
+{
+    WOParameterCheck(name != nil);
+    @synchronized (self)
+    {
+        NSUInteger index = [categoryNames indexOfObject:name];
+        if (index != NSNotFound)
+            return (WOLogCategory)index;
+        if ([categoryNames count] >= WO_LOG_MAX_CATEGORIES)
+            [NSException raise:NSRangeException
+                        format:@"cannot register category \"%@\": limit of %d categories reached",
+                               name, WO_LOG_MAX_CATEGORIES];
+
+        WOLogCategory category = (WOLogCategory)[categoryNames count];
+        NSNumber *pending = [pendingCategoryLevels objectForKey:name];
+        if (!pending)
+            pending = [pendingCategoryLevels objectForKey:@"*"];
+        WOLogCategoryLevels[category] = pending ? [pending unsignedIntValue] : [self logLevel];
+        WO_WRITE_MEMORY_BARRIER();
+        [categoryNames addObject:[name copy]];
+        return category;
+    }
+}
+
+- (NSString *)nameForCategory:(WOLogCategory)category
+{
+    @synchronized (self)
+    {
+        return category < [categoryNames count] ? [categoryNames objectAtIndex:category] : nil;
+    }
+}
+
+- (unsigned)levelForCategory:(WOLogCategory)category
+{
+    WOParameterCheck(category < WO_LOG_MAX_CATEGORIES);
+    return WOLogCategoryLevels[category];
+}
+
+- (void)setLevel:(unsigned)level forCategory:(WOLogCategory)category
+{
+    WOParameterCheck(category < WO_LOG_MAX_CATEGORIES);
+    if (category == WO_LOG_DEFAULT_CATEGORY)
+        [self setLogLevel:level];   // keeps the two in sync
+    else
+    {
+        WOLogCategoryLevels[category] = level;
+        [self refreshLogSites];
+    }
+}
+
+- (void)setLevel:(unsigned)level forCategoryNamed:(NSString *)name
+{
+    WOParameterCheck(name != nil);
+    @synchronized (self)
+    {
+        if ([name isEqualToString:@"*"])
+        {
+            // applies to categories registered in the future too, unless they
+            // have their own override
+            [pendingCategoryLevels setObject:WO_UNSIGNED(level) forKey:name];
+            for (WOLogCategory category = 0, max = (WOLogCategory)[categoryNames count]; category < max; category++)
+                [self setLevel:level forCategory:category];
+            return;
+        }
+        NSUInteger index = [categoryNames indexOfObject:name];
+        if (index == NSNotFound)
+            [pendingCategoryLevels setObject:WO_UNSIGNED(level) forKey:name];
+        else
+            [self setLevel:level forCategory:(WOLogCategory)index];
+    }
+}
+
+- (void)applyCategoryLevels:(NSString *)specification
+{
+    if (!specification) return;
+    NSMutableCharacterSet *separators = [NSMutableCharacterSet whitespaceAndNewlineCharacterSet];
+    [separators addCharactersInString:@","];
+    for (NSString *entry in [specification componentsSeparatedByCharactersInSet:separators])
+    {
+        if ([entry length] == 0)
+            continue;
+        NSRange equals = [entry rangeOfString:@"="];
+        NSString *name = equals.location == NSNotFound ? nil : [entry substringToIndex:equals.location];
+        NSString *value = equals.location == NSNotFound ? nil : [entry substringFromIndex:NSMaxRange(equals)];
+        NSScanner *scanner = value ? [NSScanner scannerWithString:value] : nil;
+        int level;
+        if ([name length] == 0 || ![scanner scanInt:&level] || ![scanner isAtEnd] || level < 0)
+        {
+            NSLog(@"Warning: ignoring malformed log category level \"%@\"", entry);
+            continue;
+        }
+        [self setLevel:(unsigned)level forCategoryNamed:name];
+    }
+}
+
+- (void)applyCategoryLevelsFromFile:(NSString *)path
+{
+    NSError *error = nil;
+    NSString *contents = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:&error];
+    if (contents)
+        [self applyCategoryLevels:contents];
+    else
+        NSLog(@"Warning: could not read log category levels from \"%@\" (%@)", path, [error localizedDescription]);
+}
+
+- (void)reloadCategoryLevels
+{
+    const char *environment = getenv(WO_LOG_CATEGORY_LEVELS_ENVIRONMENT_VARIABLE);
+    if (environment)
+        [self applyCategoryLevels:[NSString stringWithUTF8String:environment]];
+    NSString *path = [self categoryLevelsPath];
+    if (path)
+        [self applyCategoryLevelsFromFile:path];
+}
+
+- (void)reloadCategoryLevelsOnSignal:(int)signalNumber
+{
+    signal(signalNumber, SIG_IGN);  // otherwise default action (usually termination) still occurs
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0);
+    dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_SIGNAL, signalNumber, 0, queue);
+    if (!source)
+    {
+        NSLog(@"Error: dispatch_source_create() failed for signal %d", signalNumber);
+        return;
+    }
+    dispatch_source_set_event_handler(source, ^{
+        [self reloadCategoryLevels];
+    });
+    dispatch_resume(source);
+    @synchronized (self)
+    {
+        // the +1 reference returned by dispatch_source_create() keeps the source alive
+        [signalSources addObject:[NSValue valueWithPointer:source]];
+    }
+}
+
+- (void)vLogCategory:(WOLogCategory)category level:(unsigned)level message:(NSString *)format args:(va_list)args
+{
+    WOParameterCheck([format isKindOfClass:[NSString class]]);
+    [self logCategory:category level:level formattedMessage:[NSString stringWithFormat:format arguments:args]];
+}
+
+- (void)logCategory:(WOLogCategory)category level:(unsigned)level formattedMessage:(NSString *)message
+{
+    WOParameterCheck(message != nil);
+    WOParameterCheck(category < WO_LOG_MAX_CATEGORIES);
+    if (category != WO_LOG_DEFAULT_CATEGORY)
+        message = WO_STRING(@"[%@] %@", [self nameForCategory:category], message);
+    WOLogFlightRecorder *recorder = flightRecorder;
+    if (recorder)
+        [self recordMessage:message level:level inFlightRecorder:recorder];
+    if (level > WOLogCategoryLevels[category]) return;  // only enabled for the recorder
+    if ([self logsToFileByDefault])
+        [self writeMessageToFile:message level:level];
+    else
+        [self writeMessageToStdErr:message level:level];
+}
+
+- (void)logCategory:(WOLogCategory)category level:(unsigned)level message:(NSString *)format, ...
+{
+    if (!format || !WOLogCategoryEnabled(category, level)) return;
+    va_list args;
+    va_start(args, format);
+    [self vLogCategory:category level:level message:[self stringForObject:format] args:args];
+    va_end(args);
+}
+
+- (void)logCategory:(WOLogCategory)category level:(unsigned)level warning:(NSString *)format, ...
+{
+    if (!format || !WOLogCategoryEnabled(category, level)) return;
+    va_list args;
+    va_start(args, format);
+    [self vLogCategory:category
+                 level:level
+               message:[[self stringForObject:format] stringByPrependingString:WO_LOG_WARNING_PREFIX] args:args];
+    va_end(args);
+}
+
+- (void)logCategory:(WOLogCategory)category level:(unsigned)level error:(NSString *)format, ...
+{
+    if (!format || !WOLogCategoryEnabled(category, level)) return;
+    va_list args;
+    va_start(args, format);
+    [self vLogCategory:category
+                 level:level
+               message:[[self stringForObject:format] stringByPrependingString:WO_LOG_ERROR_PREFIX] args:args];
+    va_end(args);
+}
+
+#pragma mark -
+#pragma mark Sink methods
+
+- (void)addSink:(WOLogSink *)sink
+{
+    WOParameterCheck(sink != nil);
+    @synchronized (self)
+    {
+        NSArray *updated = sinks ? [sinks arrayByAddingObject:sink] : [NSArray arrayWithObject:sink];
+        WO_WRITE_MEMORY_BARRIER();
+        sinks = updated;
+    }
+}
+
+- (void)removeSink:(WOLogSink *)sink
+{
+    @synchronized (self)
+    {
+        NSMutableArray *updated = [sinks mutableCopy];
+        [updated removeObjectIdenticalTo:sink];
+        WO_WRITE_MEMORY_BARRIER();
+        sinks = [updated count] ? [updated copy] : nil;
+    }
+}
+
+- (NSArray *)sinks
+{
+    NSArray *installedSinks = sinks;
+    WO_READ_MEMORY_BARRIER();
+    return installedSinks ? installedSinks : [NSArray array];
+}
+
+- (void)submitMessage:(NSString *)message level:(unsigned)level toSinks:(NSArray *)someSinks
+{
+    // format once; the same record is shared by all sinks
+    char header[128];
+    size_t headerLength = WOLogFormatHeader(header, sizeof(header), processNameBuffer, [self processIdentifier]);
+    const char *utf8 = [message UTF8String];
+    size_t messageLength = strlen(utf8);
+    size_t length = headerLength + messageLength + 1;
+    char *bytes = emalloc(length);
+    memcpy(bytes, header, headerLength);
+    memcpy(bytes + headerLength, utf8, messageLength);
+    bytes[length - 1] = '\n';
+
+    // immutable, so WOLogRecord's copy is just a reference
+    NSData *data = [[NSData alloc] initWithBytesNoCopy:bytes length:length freeWhenDone:YES];
+    WOLogRecord *record = [[WOLogRecord alloc] initWithData:data level:level];
+    for (WOLogSink *sink in someSinks)
+        [sink submitRecord:record];
+}
+
+#pragma mark -
+#pragma mark Shared file methods
+
+- (BOOL)appendMessage:(NSString *)message toSharedFile:(NSString *)path
+{
+    WOLogFileSink *sink = sharedFileSink;
+    WO_READ_MEMORY_BARRIER();
+    if (!sink || ![[sink path] isEqualToString:path])
+    {
+        @synchronized (self)
+        {
+            sink = sharedFileSink;
+            if (!sink || ![[sink path] isEqualToString:path])
+            {
+                // the old sink closes its descriptor when collected, so
+                // threads still writing through it are unaffected
+                sink = [[WOLogFileSink alloc] initWithPath:path];
+                WO_WRITE_MEMORY_BARRIER();
+                sharedFileSink = sink;
+            }
+        }
+    }
+
+    // typical records are assembled on the stack and written in one piece
+    char stackBytes[WO_LOG_ATOMIC_APPEND_SIZE];
+    char header[128];
+    size_t headerLength = WOLogFormatHeader(header, sizeof(header), processNameBuffer, [self processIdentifier]);
+    const char *utf8 = [message UTF8String];
+    size_t messageLength = strlen(utf8);
+    size_t length = headerLength + messageLength + 1;
+    char *bytes = length <= sizeof(stackBytes) ? stackBytes : emalloc(length);
+    memcpy(bytes, header, headerLength);
+    memcpy(bytes + headerLength, utf8, messageLength);
+    bytes[length - 1] = '\n';
+    BOOL appended = [sink appendBytes:bytes length:length];
+    if (bytes != stackBytes)
+        free(bytes);
+    return appended;
+}
+
+#pragma mark -
+#pragma mark Asynchronous logging methods
+
+// formats the record header and message straight into the claimed slot
+- (BOOL)enqueueMessage:(NSString *)message level:(unsigned)level
+{
+    WOLogRecordSlot *slot = NULL;
+    for (unsigned attempt = 0; attempt < WO_LOG_CLAIM_ATTEMPTS; attempt++)
+    {
+        if ((slot = WOLogRingBufferClaim(ringBuffer)))
+            break;
+        sched_yield();
+    }
+    if (!slot)
+    {
+        OSAtomicIncrement64(&ringBuffer->dropped);
+        return NO;
+    }
+
+    char *bytes = slot->bytes;
+    size_t length = WOLogFormatHeader(bytes, WO_LOG_RECORD_CAPACITY, processNameBuffer, [self processIdentifier]);
+
+    // leave room for a truncation marker and the newline
+    NSUInteger used = 0;
+    NSRange remaining = NSMakeRange(0, 0);
+    [message getBytes:bytes + length
+            maxLength:WO_LOG_RECORD_CAPACITY - length - 4
+           usedLength:&used
+             encoding:NSUTF8StringEncoding
+              options:NSStringEncodingConversionAllowLossy
+                range:NSMakeRange(0, [message length])
+       remainingRange:&remaining];
+    length += used;
+    if (remaining.length > 0)
+    {
+        memcpy(bytes + length, "...", 3);
+        length += 3;
+    }
+    bytes[length++] = '\n';
+
+    slot->length    = (uint32_t)length;
+    slot->level     = level;
+    WOLogRingBufferPublish(ringBuffer, slot);
+    return YES;
+}
+
+- (void)drainRingBufferInDetachedThread:(id)ignored
+{
+    NSString    *openPath           = nil;
+    int         descriptor          = -1;
+    int64_t     reportedDropped     = 0;
+    for (;;)
+    {
+        // gather a run of published records
+        struct iovec vectors[WO_LOG_WRITE_BATCH];
+        int64_t count = 0;
+        WOLogRecordSlot *slot;
+        while (count < WO_LOG_WRITE_BATCH && (slot = WOLogRingBufferPeek(ringBuffer, count)))
+        {
+            vectors[count].iov_base  = slot->bytes;
+            vectors[count].iov_len   = slot->length;
+            count++;
+        }
+        if (count == 0)
+        {
+            WOLogRingBufferWait(ringBuffer, 100 * NSEC_PER_MSEC);
+            continue;
+        }
+
+        // (re)open the log file if the path has changed
+        NSString *path = [self logFilePath];
+        if (!path) path = [self defaultLogFilePath];
+        if (descriptor < 0 || (path != openPath && ![path isEqualToString:openPath]))
+        {
+            if (descriptor >= 0)
+                close(descriptor);
+            descriptor = open([path fileSystemRepresentation], O_CREAT | O_WRONLY | O_APPEND, 0644);
+            if (descriptor < 0)
+                NSLog(@"Error: Could not open log file \"%@\" (errno = %d): %lld messages lost",
+                      path, errno, (long long)count);
+            openPath = path;
+        }
+
+        if (descriptor >= 0)
+        {
+            ssize_t total = 0;
+            for (int64_t i = 0; i < count; i++)
+                total += vectors[i].iov_len;
+            ssize_t written = writev(descriptor, vectors, (int)count);
+            if (written != total)
+                perror("writev");
+            [self didWriteToLogFile:path];  // before consuming, so that flush also waits for any sync
+        }
+        WOLogRingBufferConsume(ringBuffer, count);
+
+        // report records lost because the buffer was full since the last report
+        int64_t dropped = ringBuffer->dropped;
+        if (dropped > reportedDropped && descriptor >= 0)
+        {
+            char notice[128];
+            int length = snprintf(notice, sizeof(notice), "%s[%d] Warning: %lld log records dropped (buffer full)\n",
+                                  processNameBuffer, [self processIdentifier], (long long)(dropped - reportedDropped));
+            if (write(descriptor, notice, (size_t)length) != length)
+                perror("write");
+            reportedDropped = dropped;
+        }
+    }
+}
+
+- (void)flush
+{
+    if (!ringBuffer)
+        return;
+    int64_t target = ringBuffer->head;
+    while (ringBuffer->tail < target)
+        usleep(100);
+}
+
+- (int64_t)droppedRecordCount
+{
+    return ringBuffer ? ringBuffer->dropped : 0;
+}
+
+#pragma mark -
+#pragma mark Durability methods
+
+- (WOLogSyncer *)syncerForPath:(NSString *)path
+{
+    WOLogSyncer *current = syncer;
+    WO_READ_MEMORY_BARRIER();
+    if (!current || ![[current path] isEqualToString:path])
+    {
+        @synchronized (self)
+        {
+            current = syncer;
+            if (!current || ![[current path] isEqualToString:path])
+            {
+                current = [[WOLogSyncer alloc] initWithPath:path];
+                WO_WRITE_MEMORY_BARRIER();
+                syncer = current;
+            }
+        }
+    }
+    return current;
+}
+
+- (void)didWriteToLogFile:(NSString *)path
+{
+    WOLogDurability mode = durability;
+    if (mode == WOLogDurabilityNone)
+        return;
+    WOLogSyncer *current = [self syncerForPath:path];
+    if (mode == WOLogDurabilityPeriodic)
+        [current noteWrite];
+    else if (![current sync])
+        NSLog(@"Error: Could not sync log file \"%@\" (errno = %d)", path, errno);
+}
+
+- (BOOL)syncLogFile
+{
+    [self flush];
+    NSString *path = [self logFilePath];
+    if (!path) path = [self defaultLogFilePath];
+    return [[self syncerForPath:path] sync];
+}
+
+- (WOLogSyncStatistics)syncStatistics
+{
+    WOLogSyncer *current = syncer;
+    WO_READ_MEMORY_BARRIER();
+    if (current)
+        return [current statistics];
+    WOLogSyncStatistics none = { 0 };
+    return none;
+}
+
+- (void)startDurabilityTimer
+{
+    @synchronized (self)
+    {
+        if (durabilityTimer)
+        {
+            dispatch_source_cancel(durabilityTimer);
+            dispatch_release(durabilityTimer);
+            durabilityTimer = NULL;
+        }
+        if (durability != WOLogDurabilityPeriodic || durabilityInterval <= 0)
+            return;
+        dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+        durabilityTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
+        if (!durabilityTimer)
+        {
+            NSLog(@"Error: dispatch_source_create() failed for durability timer");
+            return;
+        }
+        uint64_t interval = (uint64_t)(durabilityInterval * NSEC_PER_SEC);
+        dispatch_source_set_timer(durabilityTimer, dispatch_time(DISPATCH_TIME_NOW, interval), interval,
+                                  interval / 10);
+        dispatch_source_set_event_handler(durabilityTimer, ^{
+            WOLogSyncer *current = syncer;
+            WO_READ_MEMORY_BARRIER();
+            if (current && ![current syncIfDirty])
+                NSLog(@"Error: Could not sync log file \"%@\"", [current path]);
+        });
+        dispatch_resume(durabilityTimer);
+    }
+}
+
+#pragma mark -
+#pragma mark Call-site methods
+
+- (void)setEnabled:(BOOL)flag forLogSitesInFile:(NSString *)file line:(int)line
+{
+    WOParameterCheck(file != nil);
+    const char *name = [file UTF8String];
+    @synchronized (self)
+    {
+        [logSiteSwitches addObject:WO_ARRAY(file, WO_INT(line), WO_BOOL(flag))];
+        for (WOLogSite *site = WOLogSiteList; site; site = site->next)
+        {
+            if (!WOLogSiteMatches(site, name, line))
+                continue;
+            if (flag)
+                site->state &= ~WO_LOG_SITE_SWITCHED_OFF;
+            else
+                site->state |= WO_LOG_SITE_SWITCHED_OFF;
+            WOLogSiteUpdate(site);
+        }
+    }
+}
+
+- (void)registerLogSite:(WOLogSite *)site
+{
+    @synchronized (self)
+    {
+        if (site->state & WO_LOG_SITE_REGISTERED)
+            return; // another thread got here first
+
+        // later switches take precedence over earlier ones
+        for (NSArray *switchSetting in logSiteSwitches)
+        {
+            if (!WOLogSiteMatches(site, [[switchSetting objectAtIndex:0] UTF8String],
+                                  [[switchSetting objectAtIndex:1] intValue]))
+                continue;
+            if ([[switchSetting objectAtIndex:2] boolValue])
+                site->state &= ~WO_LOG_SITE_SWITCHED_OFF;
+            else
+                site->state |= WO_LOG_SITE_SWITCHED_OFF;
+        }
+        site->layout = WOLogSiteParse(site);
+        site->next = WOLogSiteList;
+        WOLogSiteList = site;
+        WOLogSiteUpdate(site);
+        WO_WRITE_MEMORY_BARRIER();  // publish the layout before the flag
+        site->state |= WO_LOG_SITE_REGISTERED;
+    }
+}
+
+- (void)refreshLogSites
+{
+    @synchronized (self)
+    {
+        for (WOLogSite *site = WOLogSiteList; site; site = site->next)
+            WOLogSiteUpdate(site);
+    }
+}
+
+#pragma mark -
+#pragma mark Flight recorder methods
+
+- (BOOL)startFlightRecorderAtPath:(NSString *)path
+{
+    WOParameterCheck(path != nil);
+    WOLogFlightRecorder *recorder =
+        [[WOLogFlightRecorder alloc] initWithPath:path capacity:WO_LOG_FLIGHT_RECORDER_DEFAULT_CAPACITY];
+    if (!recorder)
+        return NO;
+    [self setFlightRecorder:recorder];
+    return YES;
+}
+
+- (void)recordMessage:(NSString *)message level:(unsigned)level inFlightRecorder:(WOLogFlightRecorder *)recorder
+{
+    // formatted on the stack: recording must not allocate or make system calls
+    char bytes[WO_LOG_FLIGHT_RECORDER_MAXIMUM_RECORD];
+    size_t length = WOLogFormatHeader(bytes, sizeof(bytes), processNameBuffer, [self processIdentifier]);
+    NSUInteger used = 0;
+    [message getBytes:bytes + length
+            maxLength:sizeof(bytes) - length - 1
+           usedLength:&used
+             encoding:NSUTF8StringEncoding
+              options:NSStringEncodingConversionAllowLossy
+                range:NSMakeRange(0, [message length])
+       remainingRange:NULL];
+    length += used;
+    bytes[length++] = '\n';
+    [recorder recordBytes:bytes length:length level:level];
+}
+
+#pragma mark -
+#pragma mark Throttling methods
+
+- (void)logSuppressionSummaries
+{
+    for (WOLogThrottle *throttle = WOLogThrottleList; throttle; throttle = throttle->next)
+    {
+        int32_t suppressed;
+        do
+            suppressed = throttle->suppressed;
+        while (!OSAtomicCompareAndSwap32Barrier(suppressed, 0, &throttle->suppressed));
+        if (suppressed > 0)
+            [self logLevel:(unsigned)throttle->level
+                   message:@"suppressed %d similar message%s (%s:%d)", suppressed, suppressed == 1 ? "" : "s",
+                           throttle->file, throttle->line];
+    }
+}
+
+- (void)startSuppressionSummaryTimer
+{
+    @synchronized (self)
+    {
+        if (suppressionSummaryTimer || suppressionSummaryInterval <= 0)
+            return;
+        dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0);
+        suppressionSummaryTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
+        if (!suppressionSummaryTimer)
+        {
+            NSLog(@"Error: dispatch_source_create() failed for suppression summary timer");
+            return;
+        }
+        uint64_t interval = (uint64_t)(suppressionSummaryInterval * NSEC_PER_SEC);
+        dispatch_source_set_timer(suppressionSummaryTimer, dispatch_time(DISPATCH_TIME_NOW, interval), interval,
+                                  interval / 10);
+        dispatch_source_set_event_handler(suppressionSummaryTimer, ^{
+            [self logSuppressionSummaries];
+        });
+        dispatch_resume(suppressionSummaryTimer);
+    }
+}
+
 #pragma mark -
 #pragma mark Utility methods
 
@@ -504,11 +1309,468 @@ WOLogManager *WOSharedLogManager = nil;
 #pragma mark -
 #pragma mark Properties
 
-@synthesize processName;
+- (NSString *)processName
+{
+    @synchronized (self)
+    {
+        return processName;
+    }
+}
+
+- (void)setProcessName:(NSString *)aName
+{
+    @synchronized (self)
+    {
+        processName = [aName copy];
+        if (!aName || ![aName getCString:processNameBuffer maxLength:sizeof(processNameBuffer)
+                                encoding:NSUTF8StringEncoding])
+            strlcpy(processNameBuffer, aName ? "(unknown)" : "(null)", sizeof(processNameBuffer));
+    }
+}
+
 @synthesize processIdentifier;
-@synthesize logLevel;
+
+- (unsigned)logLevel
+{
+    return logLevel;
+}
+
+- (void)setLogLevel:(unsigned)aLogLevel
+{
+    logLevel = aLogLevel;
+    WOLogCategoryLevels[WO_LOG_DEFAULT_CATEGORY] = aLogLevel;
+    [self refreshLogSites];
+}
+
 @synthesize logFilePath;
 @synthesize defaultLogFilePath;
 @synthesize logsToFileByDefault;
 
+@synthesize logsToSharedFile;
+
+- (WOLogFlightRecorder *)flightRecorder
+{
+    return flightRecorder;
+}
+
+- (void)setFlightRecorder:(WOLogFlightRecorder *)aRecorder
+{
+    flightRecorder = aRecorder;
+    WO_WRITE_MEMORY_BARRIER();
+    WOLogFlightRecorderLevel = aRecorder ? ASL_LEVEL_DEBUG : 0;
+    [self refreshLogSites];
+}
+
+- (BOOL)logsAsynchronously
+{
+    return logsAsynchronously;
+}
+
+- (void)setLogsAsynchronously:(BOOL)flag
+{
+    @synchronized (self)
+    {
+        if (flag && !ringBuffer)
+        {
+            ringBuffer = WOLogRingBufferCreate(WO_LOG_RING_BUFFER_DEFAULT_CAPACITY);
+            if (!ringBuffer)
+            {
+                NSLog(@"Error: could not allocate log ring buffer; logging synchronously");
+                return;
+            }
+            [NSThread detachNewThreadSelector:@selector(drainRingBufferInDetachedThread:) toTarget:self withObject:nil];
+            atexit(WOLogManagerFlushAtExit);
+        }
+        if (!flag)
+            [self flush];   // records already queued must not be overtaken by synchronous writes
+        logsAsynchronously = flag;
+    }
+}
+
+- (WOLogDurability)durability
+{
+    return durability;
+}
+
+- (void)setDurability:(WOLogDurability)aDurability
+{
+    @synchronized (self)
+    {
+        durability = aDurability;
+        [self startDurabilityTimer];
+    }
+}
+
+- (NSTimeInterval)durabilityInterval
+{
+    @synchronized (self)
+    {
+        return durabilityInterval;
+    }
+}
+
+- (void)setDurabilityInterval:(NSTimeInterval)anInterval
+{
+    @synchronized (self)
+    {
+        durabilityInterval = anInterval;
+        [self startDurabilityTimer];
+    }
+}
+
+- (NSTimeInterval)suppressionSummaryInterval
+{
+    @synchronized (self)
+    {
+        return suppressionSummaryInterval;
+    }
+}
+
+- (void)setSuppressionSummaryInterval:(NSTimeInterval)anInterval
+{
+    @synchronized (self)
+    {
+        suppressionSummaryInterval = anInterval;
+        if (suppressionSummaryTimer)
+        {
+            dispatch_source_cancel(suppressionSummaryTimer);
+            dispatch_release(suppressionSummaryTimer);
+            suppressionSummaryTimer = NULL;
+        }
+    }
+    if (WOLogThrottleList)  // sites already dropping messages: restart with new interval
+        [self startSuppressionSummaryTimer];
+}
+
+- (NSString *)categoryLevelsPath
+{
+    @synchronized (self)
+    {
+        return categoryLevelsPath;
+    }
+}
+
+- (void)setCategoryLevelsPath:(NSString *)aPath
+{
+    @synchronized (self)
+    {
+        categoryLevelsPath = [aPath copy];
+    }
+    if (aPath)
+        [self applyCategoryLevelsFromFile:aPath];
+}
+
 @end
+
+#pragma mark -
+#pragma mark Functions
+
+//! Counts a dropped message and, the first time a site drops a message, adds
+//! it to the summary list and makes sure the summary timer is running.
+static void WOLogThrottleSuppress(WOLogThrottle *throttle, unsigned level)
+{
+    throttle->level = (int32_t)level;
+    OSAtomicIncrement32Barrier(&throttle->suppressed);
+    if (throttle->registered || !OSAtomicCompareAndSwap32Barrier(0, 1, &throttle->registered))
+        return;
+    WOLogThrottle *head;
+    do
+    {
+        head = WOLogThrottleList;
+        throttle->next = head;
+    } while (!OSAtomicCompareAndSwapPtrBarrier(head, throttle, (void * volatile *)&WOLogThrottleList));
+    [WOLog startSuppressionSummaryTimer];
+}
+
+BOOL WOLogThrottleSample(WOLogThrottle *throttle, unsigned level)
+{
+    int64_t count = OSAtomicIncrement64(&throttle->state);
+    if (throttle->interval <= 1 || (count - 1) % throttle->interval == 0)
+        return YES;
+    WOLogThrottleSuppress(throttle, level);
+    return NO;
+}
+
+BOOL WOLogThrottleAcquire(WOLogThrottle *throttle, unsigned level)
+{
+    int64_t now = WOMonotonicNanoseconds();
+    int64_t observed, next;
+    do
+    {
+        observed = throttle->state;
+        int64_t arrival = observed < now ? now : observed;    // earlier than now: bucket is full
+        if (arrival - now > throttle->tolerance)            // bucket is empty
+        {
+            WOLogThrottleSuppress(throttle, level);
+            return NO;
+        }
+        next = arrival + throttle->emissionInterval;
+    } while (!OSAtomicCompareAndSwap64Barrier(observed, next, &throttle->state));
+    return YES;
+}
+
+#pragma mark -
+#pragma mark Call-site functions
+
+//! Returns the type of the argument consumed by a conversion, given its
+//! conversion character and length modifier.
+static WOLogArgumentType WOLogArgumentTypeForConversion(char conversion, const char *modifier, size_t modifierLength)
+{
+    switch (conversion)
+    {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c':
+            if (modifierLength == 0 || modifier[0] == 'h')
+                return WOLogArgumentInt;
+            if (conversion == 'c')
+                return WOLogArgumentUnsupported;   // wint_t
+            if (modifierLength == 1 && modifier[0] == 'l')
+                return WOLogArgumentLong;
+            if ((modifierLength == 2 && modifier[0] == 'l' && modifier[1] == 'l') ||
+                (modifierLength == 1 && modifier[0] == 'q'))
+                return WOLogArgumentLongLong;
+            if (modifierLength == 1 && modifier[0] == 'z')
+                return WOLogArgumentSize;
+            if (modifierLength == 1 && modifier[0] == 't')
+                return WOLogArgumentPointerDifference;
+            if (modifierLength == 1 && modifier[0] == 'j')
+                return WOLogArgumentIntMax;
+            return WOLogArgumentUnsupported;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+            if (modifierLength == 0 || (modifierLength == 1 && modifier[0] == 'l'))
+                return WOLogArgumentDouble;
+            return WOLogArgumentUnsupported;       // long double
+        case 's':
+            return modifierLength == 0 ? WOLogArgumentCString : WOLogArgumentUnsupported;
+        case 'p':
+            return modifierLength == 0 ? WOLogArgumentPointer : WOLogArgumentUnsupported;
+        case '@':
+            return modifierLength == 0 ? WOLogArgumentObject : WOLogArgumentUnsupported;
+        default:
+            return WOLogArgumentUnsupported;
+    }
+}
+
+//! Splits the site's format into literal text and conversion specifications.
+//! Called once per site, at registration.
+static struct WOLogSiteLayout *WOLogSiteParse(WOLogSite *site)
+{
+    const char *format      = site->format;
+    size_t formatLength     = strlen(format);
+    char location[PATH_MAX + 32] = "";
+    if (site->state & WO_LOG_SITE_APPENDS_LOCATION)
+        snprintf(location, sizeof(location), " (%s:%d)", site->file, site->line);
+    size_t locationLength   = strlen(location);
+
+    struct WOLogSiteLayout *layout = emalloc(sizeof(struct WOLogSiteLayout));
+    memset(layout, 0, sizeof(struct WOLogSiteLayout));
+    layout->literals        = emalloc(formatLength + locationLength + 1);
+    layout->specs           = emalloc(formatLength + WO_LOG_SITE_MAX_ARGUMENTS + 1);
+    size_t specsLength      = 0;
+
+    for (size_t i = 0; i < formatLength && !layout->fallback; )
+    {
+        if (format[i] != '%')
+        {
+            layout->literals[layout->literalsLength++] = format[i++];
+            continue;
+        }
+        if (format[i + 1] == '%')
+        {
+            layout->literals[layout->literalsLength++] = '%';
+            i += 2;
+            continue;
+        }
+
+        size_t start = i++;
+        i += strspn(format + i, "-+ #0'");                  // flags
+        i += strspn(format + i, "0123456789");              // width
+        if (format[i] == '.')                               // precision
+        {
+            i++;
+            i += strspn(format + i, "0123456789");
+        }
+        const char *modifier = format + i;
+        size_t modifierLength = strspn(modifier, "hlqLzjt");
+        i += modifierLength;
+        char conversion = format[i];
+        if (conversion)
+            i++;
+        WOLogArgumentType type = WOLogArgumentTypeForConversion(conversion, modifier, modifierLength);
+
+        // objects are appended as is: reject what would be silently ignored
+        WOCCheck(type != WOLogArgumentObject || i - start == 2);
+        if (type == WOLogArgumentUnsupported || layout->argumentCount == WO_LOG_SITE_MAX_ARGUMENTS)
+        {
+            layout->fallback = YES;
+            break;
+        }
+
+        WOLogSiteArgument *argument = &layout->arguments[layout->argumentCount++];
+        argument->type          = type;
+        argument->literalEnd    = layout->literalsLength;
+        argument->spec          = specsLength;
+        memcpy(layout->specs + specsLength, format + start, i - start);
+        specsLength += i - start;
+        layout->specs[specsLength++] = '\0';
+    }
+
+    memcpy(layout->literals + layout->literalsLength, location, locationLength);
+    layout->literalsLength += locationLength;
+    layout->literals[layout->literalsLength] = '\0';
+    return layout;
+}
+
+static BOOL WOLogSiteMatches(WOLogSite *site, const char *file, int line)
+{
+    if (line != 0 && line != site->line)
+        return NO;
+    if (strcmp(site->file, file) == 0)
+        return YES;
+    const char *lastComponent = strrchr(site->file, '/');
+    return lastComponent && strcmp(lastComponent + 1, file) == 0;
+}
+
+//! Recomputes WO_LOG_SITE_ENABLED; must be called while synchronized on the
+//! shared manager.
+static void WOLogSiteUpdate(WOLogSite *site)
+{
+    BOOL enabled = !(site->state & WO_LOG_SITE_SWITCHED_OFF) && WOLogCategoryEnabled(site->category, site->level);
+    if (enabled)
+        site->state |= WO_LOG_SITE_ENABLED;
+    else
+        site->state &= ~WO_LOG_SITE_ENABLED;
+}
+
+//! Growable output buffer which starts out on the caller's stack.
+typedef struct WOLogSiteBuffer {
+
+    char    *bytes;
+    size_t  length;
+    size_t  capacity;
+    BOOL    onHeap;
+
+} WOLogSiteBuffer;
+
+static void WOLogSiteBufferReserve(WOLogSiteBuffer *buffer, size_t extra)
+{
+    if (buffer->length + extra <= buffer->capacity)
+        return;
+    size_t capacity = MAX(buffer->capacity * 2, buffer->length + extra);
+    char *bytes = emalloc(capacity);
+    memcpy(bytes, buffer->bytes, buffer->length);
+    if (buffer->onHeap)
+        free(buffer->bytes);
+    buffer->bytes       = bytes;
+    buffer->capacity    = capacity;
+    buffer->onHeap      = YES;
+}
+
+static void WOLogSiteBufferAppend(WOLogSiteBuffer *buffer, const char *bytes, size_t length)
+{
+    WOLogSiteBufferReserve(buffer, length);
+    memcpy(buffer->bytes + buffer->length, bytes, length);
+    buffer->length += length;
+}
+
+//! Appends a single printf conversion of the next argument (of \p type) in
+//! \p args to a WOLogSiteBuffer, growing it and retrying if the first attempt
+//! was truncated.
+#define WO_LOG_SITE_BUFFER_PRINTF(buffer, spec, type, args)                 \
+do                                                                          \
+{                                                                           \
+    type _value = va_arg((args), type);                                     \
+    size_t _available = (buffer)->capacity - (buffer)->length;              \
+    int _length = snprintf((buffer)->bytes + (buffer)->length, _available,  \
+                           (spec), _value);                                 \
+    if (_length < 0)                                                        \
+        break;                                                              \
+    if ((size_t)_length >= _available)                                      \
+    {                                                                       \
+        WOLogSiteBufferReserve((buffer), _length + 1);                      \
+        snprintf((buffer)->bytes + (buffer)->length, _length + 1,           \
+                 (spec), _value);                                           \
+    }                                                                       \
+    (buffer)->length += _length;                                            \
+} while (0)
+
+void WOLogSiteEmit(WOLogSite *site, ...)
+{
+    if (!(site->state & WO_LOG_SITE_REGISTERED))
+    {
+        [WOLog registerLogSite:site];
+        if (!(site->state & WO_LOG_SITE_ENABLED))
+            return;
+    }
+    WO_READ_MEMORY_BARRIER();   // pairs with the barrier in registerLogSite:
+    struct WOLogSiteLayout *layout = site->layout;
+
+    va_list args;
+    va_start(args, site);
+    NSString *message = nil;
+    if (layout->fallback)
+    {
+        message = [[NSString alloc] initWithFormat:[NSString stringWithUTF8String:site->format] arguments:args];
+        if (site->state & WO_LOG_SITE_APPENDS_LOCATION)
+            message = [message stringByAppendingFormat:@" (%s:%d)", site->file, site->line];
+    }
+    else
+    {
+        char stackBytes[WO_LOG_SITE_BUFFER_SIZE];
+        WOLogSiteBuffer buffer = { stackBytes, 0, sizeof(stackBytes), NO };
+        size_t literalStart = 0;
+        for (unsigned i = 0; i < layout->argumentCount; i++)
+        {
+            WOLogSiteArgument *argument = &layout->arguments[i];
+            WOLogSiteBufferAppend(&buffer, layout->literals + literalStart, argument->literalEnd - literalStart);
+            literalStart = argument->literalEnd;
+            const char *spec = layout->specs + argument->spec;
+            switch (argument->type)
+            {
+                case WOLogArgumentInt:
+                    WO_LOG_SITE_BUFFER_PRINTF(&buffer, spec, int, args);
+                    break;
+                case WOLogArgumentLong:
+                    WO_LOG_SITE_BUFFER_PRINTF(&buffer, spec, long, args);
+                    break;
+                case WOLogArgumentLongLong:
+                    WO_LOG_SITE_BUFFER_PRINTF(&buffer, spec, long long, args);
+                    break;
+                case WOLogArgumentSize:
+                    WO_LOG_SITE_BUFFER_PRINTF(&buffer, spec, size_t, args);
+                    break;
+                case WOLogArgumentPointerDifference:
+                    WO_LOG_SITE_BUFFER_PRINTF(&buffer, spec, ptrdiff_t, args);
+                    break;
+                case WOLogArgumentIntMax:
+                    WO_LOG_SITE_BUFFER_PRINTF(&buffer, spec, intmax_t, args);
+                    break;
+                case WOLogArgumentDouble:
+                    WO_LOG_SITE_BUFFER_PRINTF(&buffer, spec, double, args);
+                    break;
+                case WOLogArgumentCString:
+                    WO_LOG_SITE_BUFFER_PRINTF(&buffer, spec, const char *, args);
+                    break;
+                case WOLogArgumentPointer:
+                    WO_LOG_SITE_BUFFER_PRINTF(&buffer, spec, void *, args);
+                    break;
+                case WOLogArgumentObject:
+                {
+                    const char *utf8 = [[WOLog stringForObject:va_arg(args, id)] UTF8String];
+                    if (utf8)
+                        WOLogSiteBufferAppend(&buffer, utf8, strlen(utf8));
+                    break;
+                }
+                case WOLogArgumentUnsupported:
+                    break;  // not reached: such formats use the fallback path
+            }
+        }
+        WOLogSiteBufferAppend(&buffer, layout->literals + literalStart, layout->literalsLength - literalStart);
+        message = [[NSString alloc] initWithBytes:buffer.bytes length:buffer.length encoding:NSUTF8StringEncoding];
+        if (!message)   // invalid UTF-8 from a %s argument
+            message = [[NSString alloc] initWithBytes:buffer.bytes length:buffer.length encoding:NSISOLatin1StringEncoding];
+        if (buffer.onHeap)
+            free(buffer.bytes);
+    }
+    va_end(args);
+    [WOLog logCategory:site->category level:site->level formattedMessage:message];
+}
@@ -0,0 +1,56 @@
+// WOLogMemorySink.h
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// superclass header
+#import "WOLogSink.h"
+
+//! Default value for the capacity of a WOLogMemorySink.
+#define WO_LOG_MEMORY_SINK_DEFAULT_CAPACITY 1000
+
+//! Keeps the most recent records in memory, discarding the oldest once
+//! #capacity records are held. Useful for attaching recent log output to crash
+//! or bug reports.
+@interface WOLogMemorySink : WOLogSink {
+
+    NSUInteger      capacity;
+
+    //! Ring of records; once full, \c next indexes the oldest record.
+    NSMutableArray  *records;
+    NSUInteger      next;
+
+}
+
+- (id)init;
+
+//! Designated initializer.
+- (id)initWithCapacity:(NSUInteger)aCapacity;
+
+//! Returns the retained records, oldest first.
+- (NSArray *)records;
+
+@property(readonly) NSUInteger capacity;
+
+@end
@@ -0,0 +1,76 @@
+// WOLogMemorySink.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOLogMemorySink.h"
+
+// macro headers
+#import "WODebugMacros.h"
+
+@implementation WOLogMemorySink
+
+- (id)init
+{
+    return [self initWithCapacity:WO_LOG_MEMORY_SINK_DEFAULT_CAPACITY];
+}
+
+- (id)initWithCapacity:(NSUInteger)aCapacity
+{
+    WOParameterCheck(aCapacity > 0);
+    if ((self = [super init]))
+    {
+        capacity    = aCapacity;
+        records     = [NSMutableArray arrayWithCapacity:aCapacity];
+    }
+    return self;
+}
+
+- (void)writeRecord:(WOLogRecord *)record
+{
+    if ([records count] < capacity)
+        [records addObject:record];
+    else
+    {
+        [records replaceObjectAtIndex:next withObject:record];
+        next = (next + 1) % capacity;
+    }
+}
+
+- (NSArray *)records
+{
+    __block NSArray *ordered = nil;
+    dispatch_sync(queue, ^{
+        NSRange newest = NSMakeRange(0, next);
+        NSRange oldest = NSMakeRange(next, [records count] - next);
+        ordered = [[records subarrayWithRange:oldest] arrayByAddingObjectsFromArray:
+                    [records subarrayWithRange:newest]];
+    });
+    return ordered;
+}
+
+@synthesize capacity;
+
+@end
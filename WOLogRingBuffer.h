@@ -0,0 +1,132 @@
+// WOLogRingBuffer.h
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+//! \file
+//! Lock-free multi-producer, single-consumer ring buffer of fixed-size log
+//! records.
+//!
+//! All storage is allocated up front when the buffer is created. Producers
+//! claim a slot with a single compare-and-swap on the shared head counter,
+//! format their record directly into the slot, and then publish it. The
+//! single consumer drains published slots strictly in claim order.
+//!
+//! Each slot carries a sequence number which encodes its state (after the
+//! bounded queue design described by Dmitry Vyukov):
+//!
+//! - sequence == position: free, may be claimed by the producer which wins
+//!   the race to advance the head past \c position
+//! - sequence == position + 1: published, ready to be consumed
+//! - sequence == position + capacity: consumed, free for the next lap
+//!
+//! \sa http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+
+// system headers
+#import <Foundation/Foundation.h>
+#import <dispatch/dispatch.h>   /* dispatch_semaphore_t */
+
+// macro headers
+#import "WOConvenienceMacros.h"
+
+//! Total size of a record slot in bytes, including its header. Records longer
+//! than WO_LOG_RECORD_CAPACITY are truncated.
+#define WO_LOG_RECORD_SIZE      1024
+
+//! Number of bytes of record data which fit in one slot.
+#define WO_LOG_RECORD_CAPACITY  (WO_LOG_RECORD_SIZE - 2 * sizeof(int64_t))
+
+//! Default number of slots (must be a power of two).
+#define WO_LOG_RING_BUFFER_DEFAULT_CAPACITY 4096
+
+typedef struct WOLogRecordSlot {
+
+    //! Slot state (see the file-level documentation).
+    volatile int64_t    sequence;
+
+    //! Number of valid bytes in \c bytes.
+    uint32_t            length;
+
+    //! Log level of the record.
+    uint32_t            level;
+
+    char                bytes[WO_LOG_RECORD_CAPACITY];
+
+} WOLogRecordSlot;
+
+typedef struct WOLogRingBuffer {
+
+    WOLogRecordSlot     *slots;
+    int64_t             capacity;
+    int64_t             mask;
+
+    //! Next position to be claimed; shared by all producers and so kept on its
+    //! own cache line.
+    volatile int64_t    head __attribute__((aligned(64)));
+
+    //! Next position to be consumed; only touched by the consumer, but read by
+    //! WOLogRingBufferPending().
+    volatile int64_t    tail __attribute__((aligned(64)));
+
+    //! Number of records dropped because the buffer was full; incremented by
+    //! producers which give up on WOLogRingBufferClaim().
+    volatile int64_t    dropped;
+
+    //! Non-zero while the consumer is (about to be) blocked in
+    //! WOLogRingBufferWait().
+    volatile int32_t    consumerWaiting;
+
+    dispatch_semaphore_t wakeup;
+
+} WOLogRingBuffer;
+
+//! Creates a ring buffer with \p capacity slots, which is rounded up to the
+//! next power of two. Returns NULL if the buffer could not be allocated.
+WOLogRingBuffer *WOLogRingBufferCreate(int64_t capacity);
+
+void WOLogRingBufferDestroy(WOLogRingBuffer *buffer);
+
+//! Claims the next free slot for exclusive use by the calling producer, or
+//! returns NULL if the buffer is full. The caller must fill in the slot and
+//! then pass it to WOLogRingBufferPublish().
+WOLogRecordSlot *WOLogRingBufferClaim(WOLogRingBuffer *buffer);
+
+//! Makes a claimed slot visible to the consumer, waking it if necessary.
+void WOLogRingBufferPublish(WOLogRingBuffer *buffer, WOLogRecordSlot *slot);
+
+//! Returns the slot \p offset places after the oldest unconsumed slot if it
+//! and all of the slots before it have been published, otherwise NULL. This
+//! allows the consumer to gather a run of records before releasing them with
+//! a single call to WOLogRingBufferConsume(). Consumer only.
+WOLogRecordSlot *WOLogRingBufferPeek(WOLogRingBuffer *buffer, int64_t offset);
+
+//! Returns the \p count oldest slots to the producers. Consumer only.
+void WOLogRingBufferConsume(WOLogRingBuffer *buffer, int64_t count);
+
+//! Blocks the consumer until a record is published or \p timeout nanoseconds
+//! elapse. Consumer only.
+void WOLogRingBufferWait(WOLogRingBuffer *buffer, int64_t timeout);
+
+//! Returns the number of records claimed but not yet consumed.
+int64_t WOLogRingBufferPending(WOLogRingBuffer *buffer);
@@ -0,0 +1,140 @@
+// WOLogRingBuffer.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// header
+#import "WOLogRingBuffer.h"
+
+// system headers
+#import <libkern/OSAtomic.h>    /* OSAtomicCompareAndSwap64Barrier() */
+
+// other headers
+#import "WOMemoryBarrier.h"
+
+WOLogRingBuffer *WOLogRingBufferCreate(int64_t capacity)
+{
+    int64_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+
+    WOLogRingBuffer *buffer = NULL;
+    if (posix_memalign((void **)&buffer, 64, sizeof(WOLogRingBuffer)) != 0)
+        return NULL;
+    bzero(buffer, sizeof(WOLogRingBuffer));
+    if (posix_memalign((void **)&buffer->slots, 64, (size_t)size * sizeof(WOLogRecordSlot)) != 0)
+    {
+        free(buffer);
+        return NULL;
+    }
+    buffer->capacity    = size;
+    buffer->mask        = size - 1;
+    buffer->wakeup      = dispatch_semaphore_create(0);
+    for (int64_t i = 0; i < size; i++)
+        buffer->slots[i].sequence = i;
+    WO_WRITE_MEMORY_BARRIER();
+    return buffer;
+}
+
+void WOLogRingBufferDestroy(WOLogRingBuffer *buffer)
+{
+    if (!buffer)
+        return;
+    dispatch_release(buffer->wakeup);
+    free(buffer->slots);
+    free(buffer);
+}
+
+WOLogRecordSlot *WOLogRingBufferClaim(WOLogRingBuffer *buffer)
+{
+    int64_t position = buffer->head;
+    for (;;)
+    {
+        WOLogRecordSlot *slot = &buffer->slots[position & buffer->mask];
+        int64_t sequence = slot->sequence;
+        WO_READ_MEMORY_BARRIER();
+        int64_t difference = sequence - position;
+        if (difference == 0)        // slot is free: try to take it
+        {
+            if (OSAtomicCompareAndSwap64Barrier(position, position + 1, &buffer->head))
+                return slot;
+        }
+        else if (difference < 0)    // consumer hasn't freed this slot yet: full
+            return NULL;
+        position = buffer->head;    // lost the race, try again
+    }
+}
+
+void WOLogRingBufferPublish(WOLogRingBuffer *buffer, WOLogRecordSlot *slot)
+{
+    // a claimed slot's sequence still equals the position at which it was claimed
+    WO_WRITE_MEMORY_BARRIER();      // record contents must be visible before the sequence
+    slot->sequence = slot->sequence + 1;
+    WO_MEMORY_BARRIER();            // order publication before the waiting check
+    if (buffer->consumerWaiting && OSAtomicCompareAndSwap32Barrier(1, 0, &buffer->consumerWaiting))
+        dispatch_semaphore_signal(buffer->wakeup);
+}
+
+WOLogRecordSlot *WOLogRingBufferPeek(WOLogRingBuffer *buffer, int64_t offset)
+{
+    int64_t position = buffer->tail + offset;
+    WOLogRecordSlot *slot = &buffer->slots[position & buffer->mask];
+    int64_t sequence = slot->sequence;
+    WO_READ_MEMORY_BARRIER();       // record contents must not be read before the sequence
+    return sequence == position + 1 ? slot : NULL;
+}
+
+void WOLogRingBufferConsume(WOLogRingBuffer *buffer, int64_t count)
+{
+    int64_t position = buffer->tail;
+    WO_MEMORY_BARRIER();            // finish reading the records before handing them back
+    for (int64_t i = 0; i < count; i++)
+        buffer->slots[(position + i) & buffer->mask].sequence = position + i + buffer->capacity;
+    buffer->tail = position + count;
+}
+
+void WOLogRingBufferWait(WOLogRingBuffer *buffer, int64_t timeout)
+{
+    buffer->consumerWaiting = 1;
+    WO_MEMORY_BARRIER();            // order the flag before the re-check
+    if (WOLogRingBufferPeek(buffer, 0))
+    {
+        // raced with a producer; if it already cleared the flag it has also
+        // signalled, so absorb that signal to keep the semaphore balanced
+        if (!OSAtomicCompareAndSwap32Barrier(1, 0, &buffer->consumerWaiting))
+            dispatch_semaphore_wait(buffer->wakeup, DISPATCH_TIME_FOREVER);
+        return;
+    }
+    if (dispatch_semaphore_wait(buffer->wakeup, dispatch_time(DISPATCH_TIME_NOW, timeout)) != 0)
+    {
+        // timed out; as above, absorb a signal which may be in flight
+        if (!OSAtomicCompareAndSwap32Barrier(1, 0, &buffer->consumerWaiting))
+            dispatch_semaphore_wait(buffer->wakeup, DISPATCH_TIME_FOREVER);
+    }
+}
+
+int64_t WOLogRingBufferPending(WOLogRingBuffer *buffer)
+{
+    return buffer->head - buffer->tail;
+}
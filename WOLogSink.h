@@ -0,0 +1,115 @@
+// WOLogSink.h
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// superclass header
+#import "WOObject.h"
+
+// system headers
+#import <dispatch/dispatch.h>   /* dispatch_queue_t */
+
+//! Default value of the WOLogSink::maximumPendingRecords property.
+#define WO_LOG_SINK_DEFAULT_MAXIMUM_PENDING_RECORDS 1024
+
+//! A single formatted log record. Records are formatted once by WOLogManager
+//! (header, message and trailing newline) and the same immutable record is
+//! shared by every sink.
+@interface WOLogRecord : WOObject {
+
+    NSData      *data;
+    unsigned    level;
+
+}
+
+//! Designated initializer.
+- (id)initWithData:(NSData *)someData level:(unsigned)aLevel;
+
+//! The UTF-8 encoded record, including the trailing newline.
+@property(readonly) NSData      *data;
+
+@property(readonly) unsigned    level;
+
+@end
+
+//! Abstract base class for log destinations added with
+//! WOLogManager::addSink:.
+//!
+//! Each sink owns a private serial dispatch queue on which its #writeRecord:
+//! method is invoked, so a slow or stalled sink never blocks the logging
+//! thread or any other sink. At most #maximumPendingRecords records may be
+//! queued for a sink at any one time; records submitted beyond that are
+//! dropped and counted rather than queued without bound.
+//!
+//! Subclasses override #writeRecord:.
+@interface WOLogSink : WOObject {
+
+    unsigned            minimumLevel;
+    int32_t             maximumPendingRecords;
+
+    //! Records queued but not yet written; modified atomically.
+    volatile int32_t    pendingRecords;
+
+    //! Records dropped because too many were pending (or because the sink
+    //! failed to write them); modified atomically.
+    volatile int64_t    droppedRecords;
+
+    dispatch_queue_t    queue;
+
+}
+
+//! Designated initializer.
+- (id)init;
+
+//! Queues \p record to be written if its level is at or below #minimumLevel.
+//! Never blocks. May be called from any thread.
+- (void)submitRecord:(WOLogRecord *)record;
+
+//! Blocks until all records submitted before the call have been written.
+- (void)flush;
+
+//! Writes \p record to the destination. Invoked on the sink's private queue;
+//! never invoked concurrently for the same sink. Subclasses which fail to
+//! write a record should invoke #recordDropped.
+- (void)writeRecord:(WOLogRecord *)record;
+
+//! Counts one dropped record.
+- (void)recordDropped;
+
+//! Records with a level greater (less severe) than this are ignored by the
+//! sink. Defaults to ASL_LEVEL_DEBUG (that is, everything passed on by the
+//! WOLogManager is written).
+//!
+//! This can only narrow what the sink receives: WOLogManager discards
+//! messages above its own WOLogManager::logLevel (or the level of their
+//! category) before any sink sees them, so a value more verbose than that
+//! level has no further effect.
+@property           unsigned    minimumLevel;
+
+//! Defaults to WO_LOG_SINK_DEFAULT_MAXIMUM_PENDING_RECORDS.
+@property           int32_t     maximumPendingRecords;
+
+@property(readonly) int64_t     droppedRecordCount;
+
+@end
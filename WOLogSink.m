@@ -0,0 +1,116 @@
+// WOLogSink.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOLogSink.h"
+
+// system headers
+#import <asl.h>                 /* ASL_LEVEL_DEBUG */
+#import <libkern/OSAtomic.h>    /* OSAtomicIncrement32Barrier() etc */
+
+// macro headers
+#import "WODebugMacros.h"
+
+@implementation WOLogRecord
+
+- (id)initWithData:(NSData *)someData level:(unsigned)aLevel
+{
+    WOParameterCheck(someData != nil);
+    if ((self = [super init]))
+    {
+        data    = [someData copy];
+        level   = aLevel;
+    }
+    return self;
+}
+
+@synthesize data;
+@synthesize level;
+
+@end
+
+@implementation WOLogSink
+
+- (id)init
+{
+    if ((self = [super init]))
+    {
+        minimumLevel            = ASL_LEVEL_DEBUG;
+        maximumPendingRecords   = WO_LOG_SINK_DEFAULT_MAXIMUM_PENDING_RECORDS;
+        NSString *label         = WO_STRING(@"com.wincent.WOPublic.%@", NSStringFromClass([self class]));
+        queue                   = dispatch_queue_create([label UTF8String], NULL);
+    }
+    return self;
+}
+
+- (void)finalize
+{
+    dispatch_release(queue);
+    [super finalize];
+}
+
+- (void)submitRecord:(WOLogRecord *)record
+{
+    WOParameterCheck(record != nil);
+    if ([record level] > minimumLevel)
+        return;
+    if (OSAtomicIncrement32Barrier(&pendingRecords) > maximumPendingRecords)
+    {
+        OSAtomicDecrement32Barrier(&pendingRecords);
+        [self recordDropped];
+        return;
+    }
+    dispatch_async(queue, ^{
+        [self writeRecord:record];
+        OSAtomicDecrement32Barrier(&pendingRecords);
+    });
+}
+
+- (void)flush
+{
+    dispatch_sync(queue, ^{});
+}
+
+- (void)writeRecord:(WOLogRecord *)record
+{
+    [NSException raise:NSInternalInconsistencyException
+                format:@"%@ must override %@", NSStringFromClass([self class]), NSStringFromSelector(_cmd)];
+}
+
+- (void)recordDropped
+{
+    OSAtomicIncrement64Barrier(&droppedRecords);
+}
+
+- (int64_t)droppedRecordCount
+{
+    return droppedRecords;
+}
+
+@synthesize minimumLevel;
+@synthesize maximumPendingRecords;
+
+@end
@@ -0,0 +1,54 @@
+// WOLogSocketSink.h
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// superclass header
+#import "WOLogSink.h"
+
+// system headers
+#import <sys/un.h>      /* struct sockaddr_un */
+
+//! Sends each record as a single datagram to a Unix-domain datagram socket
+//! bound by a local collector process. The socket is non-blocking: records
+//! which cannot be sent immediately (for example, because the collector is
+//! not running or its receive buffer is full) are dropped and counted.
+@interface WOLogSocketSink : WOLogSink {
+
+    NSString            *path;
+    int                 descriptor;
+    struct sockaddr_un  address;
+
+}
+
+//! Designated initializer. Returns nil if the socket could not be created or
+//! if \p aPath is too long for a socket address.
+//!
+//! \throws NSInternalInconsistencyException Throws an exception if \p aPath is
+//! nil.
+- (id)initWithPath:(NSString *)aPath;
+
+@property(readonly, copy) NSString *path;
+
+@end
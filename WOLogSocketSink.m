@@ -0,0 +1,87 @@
+// WOLogSocketSink.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOLogSocketSink.h"
+
+// system headers
+#import <fcntl.h>       /* fcntl() */
+#import <sys/socket.h>  /* socket(), sendto() */
+#import <unistd.h>      /* close() */
+
+// macro headers
+#import "WODebugMacros.h"
+
+@implementation WOLogSocketSink
+
+- (id)initWithPath:(NSString *)aPath
+{
+    WOParameterCheck(aPath != nil);
+    if ((self = [super init]))
+    {
+        path        = [aPath copy];
+        descriptor  = -1;
+        bzero(&address, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (![path getFileSystemRepresentation:address.sun_path maxLength:sizeof(address.sun_path)])
+        {
+            NSLog(@"error: socket path \"%@\" is too long", path);
+            return nil;
+        }
+        address.sun_len = (unsigned char)SUN_LEN(&address);
+
+        descriptor = socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (descriptor < 0)
+        {
+            NSLog(@"error: socket() (errno = %d)", errno);
+            return nil;
+        }
+        int flags = fcntl(descriptor, F_GETFL, 0);
+        if (flags == -1 || fcntl(descriptor, F_SETFL, flags | O_NONBLOCK) == -1)
+            NSLog(@"error: fcntl() (errno = %d)", errno);
+    }
+    return self;
+}
+
+- (void)finalize
+{
+    if (descriptor >= 0)
+        close(descriptor);
+    [super finalize];
+}
+
+- (void)writeRecord:(WOLogRecord *)record
+{
+    NSData *data = [record data];
+    ssize_t sent = sendto(descriptor, [data bytes], [data length], 0,
+                          (const struct sockaddr *)&address, (socklen_t)address.sun_len);
+    if (sent != (ssize_t)[data length])
+        [self recordDropped];   // EAGAIN, ENOBUFS, ECONNREFUSED, ENOENT...
+}
+
+@synthesize path;
+
+@end
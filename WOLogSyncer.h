@@ -0,0 +1,121 @@
+// WOLogSyncer.h
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// superclass header
+#import "WOObject.h"
+
+// system headers
+#import <pthread.h>     /* pthread_mutex_t, pthread_cond_t */
+
+@class WOHistogram;
+
+//! Counters describing the syncs performed by a WOLogSyncer.
+typedef struct WOLogSyncStatistics {
+
+    //! Number of callers which asked for durability (see WOLogSyncer::sync).
+    uint64_t    requestCount;
+
+    //! Number of syncs actually performed; with group commit this is usually
+    //! much lower than #requestCount.
+    uint64_t    syncCount;
+
+    //! Number of syncs which failed.
+    uint64_t    failureCount;
+
+    uint64_t    totalNanoseconds;
+
+    //! Sync latency percentiles, from a WOHistogram of every sync performed
+    //! (so accurate to within its bucket resolution); the maximum is exact.
+    uint64_t    p50Nanoseconds;
+    uint64_t    p99Nanoseconds;
+    uint64_t    maximumNanoseconds;
+
+} WOLogSyncStatistics;
+
+//! Makes data written to a log file durable, using group commit.
+//!
+//! Syncing a file flushes all of its dirty data regardless of which
+//! descriptor (or process) wrote it, so the syncer holds a descriptor of its
+//! own and can be used alongside any of the ways WOLogManager writes to the
+//! file.
+//!
+//! Callers of #sync which arrive while a sync is in progress wait for it to
+//! finish and then share a single follow-up sync, so that under contention
+//! the number of syncs is bounded by the device's sync rate rather than by the
+//! number of callers.
+@interface WOLogSyncer : WOObject {
+
+    NSString                *path;
+    int                     descriptor;
+
+    //! Non-zero if data has been written since the last sync; see #noteWrite
+    //! and #syncIfDirty.
+    volatile int32_t        dirty;
+
+    pthread_mutex_t         lock;
+    pthread_cond_t          condition;
+
+    //! Tickets issued to callers of #sync; a caller is done once a sync which
+    //! started after its ticket was issued has completed.
+    uint64_t                requested;
+    uint64_t                completed;
+    BOOL                    syncing;
+    BOOL                    lastSyncSucceeded;
+
+    //! errno from the last failed open or sync, captured by the thread which
+    //! performed it.
+    int                     lastSyncError;
+
+    WOLogSyncStatistics     statistics;
+
+    //! Duration of every sync performed.
+    WOHistogram             *latencies;
+
+}
+
+//! Designated initializer.
+//!
+//! \throws NSInternalInconsistencyException Throws an exception if \p aPath is
+//! nil.
+- (id)initWithPath:(NSString *)aPath;
+
+//! Blocks until everything written to the file before the call is on stable
+//! storage. Returns NO, and sets errno to the cause, if the file could not be
+//! opened or synced.
+- (BOOL)sync;
+
+//! Records that data has been written to the file, for #syncIfDirty.
+- (void)noteWrite;
+
+//! Syncs the file if #noteWrite has been called since the last sync. Returns
+//! NO if a sync was needed and failed.
+- (BOOL)syncIfDirty;
+
+- (WOLogSyncStatistics)statistics;
+
+@property(readonly, copy) NSString *path;
+
+@end
@@ -0,0 +1,160 @@
+// WOLogSyncer.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOLogSyncer.h"
+
+// system headers
+#import <errno.h>               /* errno */
+#import <fcntl.h>               /* open(), fcntl() */
+#import <libkern/OSAtomic.h>    /* OSAtomicCompareAndSwap32Barrier() */
+#import <unistd.h>              /* fsync(), close() */
+
+// macro headers
+#import "WODebugMacros.h"
+
+// other headers
+#import "WOHistogram.h"
+#import "WOUsageMeter.h"        /* WOMonotonicNanoseconds() */
+
+#pragma mark -
+#pragma mark Functions
+
+//! Flushes the file's data to stable storage. On Mac OS X fsync() only pushes
+//! data as far as the drive, whose cache may be lost on power failure, so
+//! F_FULLFSYNC is used where the file system supports it.
+static BOOL WOLogSyncDescriptor(int descriptor)
+{
+#ifdef F_FULLFSYNC
+    if (fcntl(descriptor, F_FULLFSYNC) == 0)
+        return YES;
+    return fsync(descriptor) == 0;
+#else
+    return fdatasync(descriptor) == 0;
+#endif
+}
+
+@implementation WOLogSyncer
+
+- (id)initWithPath:(NSString *)aPath
+{
+    WOParameterCheck(aPath != nil);
+    if ((self = [super init]))
+    {
+        path        = [aPath copy];
+        descriptor  = -1;
+        latencies   = [[WOHistogram alloc] init];
+        pthread_mutex_init(&lock, NULL);
+        pthread_cond_init(&condition, NULL);
+    }
+    return self;
+}
+
+- (void)finalize
+{
+    if (descriptor >= 0)
+        close(descriptor);
+    pthread_cond_destroy(&condition);
+    pthread_mutex_destroy(&lock);
+    [super finalize];
+}
+
+- (BOOL)sync
+{
+    pthread_mutex_lock(&lock);
+    statistics.requestCount++;
+    uint64_t ticket = ++requested;
+    while (completed < ticket)
+    {
+        if (syncing)
+        {
+            pthread_cond_wait(&condition, &lock);
+            continue;
+        }
+
+        // lead a sync on behalf of every ticket issued so far
+        syncing = YES;
+        uint64_t target = requested;
+        if (descriptor < 0)
+            descriptor = open([path fileSystemRepresentation], O_CREAT | O_WRONLY | O_APPEND, 0644);
+        int fd = descriptor;
+        int error = fd < 0 ? errno : 0;
+        pthread_mutex_unlock(&lock);
+
+        OSAtomicCompareAndSwap32Barrier(1, 0, &dirty);  // later writes need another sync
+        WONanoseconds start = WOMonotonicNanoseconds();
+        BOOL synced = fd >= 0 && WOLogSyncDescriptor(fd);
+        if (fd >= 0 && !synced)
+            error = errno;
+        uint64_t elapsed = (uint64_t)(WOMonotonicNanoseconds() - start);
+        WOHistogramRecord(latencies, (WONanoseconds)elapsed);
+
+        pthread_mutex_lock(&lock);
+        statistics.syncCount++;
+        if (!synced)
+            statistics.failureCount++;
+        lastSyncSucceeded = synced;
+        lastSyncError = error;
+        statistics.totalNanoseconds += elapsed;
+        if (elapsed > statistics.maximumNanoseconds)
+            statistics.maximumNanoseconds = elapsed;
+        completed = target;
+        syncing = NO;
+        pthread_cond_broadcast(&condition);
+    }
+    BOOL result = lastSyncSucceeded;    // outcome of the sync which covered our ticket
+    int error = lastSyncError;
+    pthread_mutex_unlock(&lock);
+    if (!result)
+        errno = error;
+    return result;
+}
+
+- (void)noteWrite
+{
+    if (!dirty)
+        OSAtomicCompareAndSwap32Barrier(0, 1, &dirty);
+}
+
+- (BOOL)syncIfDirty
+{
+    return dirty ? [self sync] : YES;
+}
+
+- (WOLogSyncStatistics)statistics
+{
+    pthread_mutex_lock(&lock);
+    WOLogSyncStatistics copy = statistics;
+    pthread_mutex_unlock(&lock);
+    WOHistogramSummary summary = [latencies summary];
+    copy.p50Nanoseconds = (uint64_t)summary.p50;
+    copy.p99Nanoseconds = (uint64_t)summary.p99;
+    return copy;
+}
+
+@synthesize path;
+
+@end
@@ -0,0 +1,122 @@
+// WOPerformanceCounterMeter.h
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// superclass header
+#import "WOObject.h"
+
+// system headers
+#import <pthread.h>     /* pthread_mutex_t */
+#import <stdint.h>      /* int64_t */
+
+#pragma mark -
+#pragma mark Type definitions
+
+//! The hardware events counted by a WOPerformanceCounterMeter.
+typedef enum WOPerformanceCounter {
+
+    WOPerformanceCounterCycles          = 0,
+    WOPerformanceCounterInstructions    = 1,
+
+    //! Last-level cache misses
+    WOPerformanceCounterCacheMisses     = 2,
+
+    WOPerformanceCounterBranchMisses    = 3,
+    WOPerformanceCounterCount
+
+} WOPerformanceCounter;
+
+//! Returned by WOPerformanceCounterMeter::valueForCounter: when the counter
+//! cannot be read on this system (as distinct from a genuine zero).
+#define WO_PERFORMANCE_COUNTER_UNAVAILABLE  (-1LL)
+
+//! Counts hardware events (cycles, instructions, cache misses and branch
+//! misses) for the thread which creates it, using Linux perf_event_open()
+//! counters opened as a single group so that they are scheduled together.
+//!
+//! Follows WOUsageMeter's model: a new meter is running, and #pause and
+//! #resume are stackable. Counting continues in the kernel while running, so
+//! the meter only has to enable or disable the group on the transitions
+//! between running and paused; reads never block.
+//!
+//! Counters which cannot be opened (no perf_event_open() outside Linux, or
+//! restricted by perf_event_paranoid, a container or a hypervisor which hides
+//! the PMU) are reported as unavailable rather than as zero. If the kernel had
+//! to multiplex the group with other events, values are scaled up by the
+//! ratio of enabled to running time.
+@interface WOPerformanceCounterMeter : WOObject {
+
+    //! Descriptors of the opened counters (-1 for unavailable counters); the
+    //! first open descriptor is the group leader.
+    int             descriptors[WOPerformanceCounterCount];
+    int             leader;
+
+    //! Position of each available counter in the group's read format.
+    unsigned        positions[WOPerformanceCounterCount];
+    unsigned        openCount;
+
+    //! Serializes the enable/disable ioctls on the running/paused transitions.
+    pthread_mutex_t transitionLock;
+    int32_t         pauseCount;
+}
+
+#pragma mark -
+#pragma mark Creation
+
+//! Returns a meter in "running" state, counting events on the calling thread.
++ (WOPerformanceCounterMeter *)counterMeter;
+
+#pragma mark -
+#pragma mark Custom methods
+
+//! Stackable (can send multiple pause messages)
+- (void)pause;
+
+//! Stackable (can send multiple resume messages)
+- (void)resume;
+
+//! Returns the number of events counted while running, or
+//! WO_PERFORMANCE_COUNTER_UNAVAILABLE.
+- (int64_t)valueForCounter:(WOPerformanceCounter)counter;
+
+//! Returns YES if \p counter could be opened.
+- (BOOL)isCounterAvailable:(WOPerformanceCounter)counter;
+
+//! Returns a string of the form "c cycles, i instructions (x.xx IPC), m cache
+//! misses, b branch misses", with "unavailable" in place of any counter that
+//! is not available.
+- (NSString *)counterString;
+
+//! Returns the counters as NSNumbers keyed by "cycles", "instructions",
+//! "cacheMisses" and "branchMisses"; unavailable counters map to NSNull.
+- (NSDictionary *)counterDictionary;
+
+#pragma mark -
+#pragma mark Properties
+
+//! YES if at least one counter is available.
+@property(readonly, getter=isAvailable) BOOL available;
+
+@end
@@ -0,0 +1,248 @@
+// WOPerformanceCounterMeter.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOPerformanceCounterMeter.h"
+
+// system headers
+#import <unistd.h>                  /* close(), read() */
+#ifdef __linux__
+#import <linux/perf_event.h>        /* perf_event_attr, PERF_EVENT_IOC_ENABLE */
+#import <sys/ioctl.h>               /* ioctl() */
+#import <sys/syscall.h>             /* syscall(), __NR_perf_event_open */
+#endif
+
+// macro headers
+#import "WOConvenienceMacros.h"
+
+#pragma mark -
+#pragma mark Macros
+
+#if defined(__linux__) && !defined(PERF_FLAG_FD_CLOEXEC)
+#define PERF_FLAG_FD_CLOEXEC    0   /* before Linux 3.14 */
+#endif
+
+#pragma mark -
+#pragma mark Static variables
+
+static NSString *WOPerformanceCounterKeys[WOPerformanceCounterCount] = {
+    @"cycles", @"instructions", @"cacheMisses", @"branchMisses"
+};
+
+#pragma mark -
+#pragma mark Static functions
+
+#ifdef __linux__
+
+//! Opens \p counter for the calling thread, in user space only (which is all
+//! that the default perf_event_paranoid setting permits). Pass -1 as \p group
+//! to open a group leader, which starts disabled; members follow the leader.
+static int WOPerformanceCounterOpen(WOPerformanceCounter counter, int group)
+{
+    static const uint64_t configurations[WOPerformanceCounterCount] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.type             = PERF_TYPE_HARDWARE;
+    attributes.size             = sizeof(attributes);
+    attributes.config           = configurations[counter];
+    attributes.disabled         = (group == -1);
+    attributes.exclude_kernel   = 1;
+    attributes.exclude_hv       = 1;
+    attributes.read_format      = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(__NR_perf_event_open, &attributes, 0, -1, group, PERF_FLAG_FD_CLOEXEC);
+}
+
+#endif /* __linux__ */
+
+@interface WOPerformanceCounterMeter ()
+
+- (void)getValues:(int64_t *)values;
+
+@end
+
+@implementation WOPerformanceCounterMeter
+
+#pragma mark -
+#pragma mark Creation
+
++ (WOPerformanceCounterMeter *)counterMeter
+{
+    return [[self alloc] init];
+}
+
+#pragma mark -
+#pragma mark NSObject overrides
+
+- (id)init
+{
+    if ((self = [super init]))
+    {
+        leader = -1;
+        for (unsigned i = 0; i < WOPerformanceCounterCount; i++)
+        {
+            descriptors[i] = -1;
+#ifdef __linux__
+            // counters the PMU or the hypervisor does not support are skipped
+            descriptors[i] = WOPerformanceCounterOpen(i, leader);
+            if (descriptors[i] < 0)
+                continue;
+            if (leader < 0)
+                leader = descriptors[i];
+            positions[i] = openCount++;
+#endif
+        }
+        pthread_mutex_init(&transitionLock, NULL);
+        [self resume];
+    }
+    return self;
+}
+
+- (void)finalize
+{
+    for (unsigned i = 0; i < WOPerformanceCounterCount; i++)
+        if (descriptors[i] >= 0)
+            close(descriptors[i]);
+    pthread_mutex_destroy(&transitionLock);
+    [super finalize];
+}
+
+#pragma mark -
+#pragma mark Custom methods
+
+- (void)pause
+{
+    pthread_mutex_lock(&transitionLock);
+    if (--pauseCount == 0 && leader >= 0)   // pause when pause count hits 0
+    {
+#ifdef __linux__
+        ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+    pthread_mutex_unlock(&transitionLock);
+}
+
+- (void)resume
+{
+    pthread_mutex_lock(&transitionLock);
+    if (++pauseCount == 1 && leader >= 0)   // resume when pause count moves from 0 to 1
+    {
+#ifdef __linux__
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+    pthread_mutex_unlock(&transitionLock);
+}
+
+- (int64_t)valueForCounter:(WOPerformanceCounter)counter
+{
+    if (counter >= WOPerformanceCounterCount)
+        return WO_PERFORMANCE_COUNTER_UNAVAILABLE;
+    int64_t values[WOPerformanceCounterCount];
+    [self getValues:values];
+    return values[counter];
+}
+
+- (BOOL)isCounterAvailable:(WOPerformanceCounter)counter
+{
+    return counter < WOPerformanceCounterCount && descriptors[counter] >= 0;
+}
+
+- (NSString *)counterString
+{
+    static const char *names[WOPerformanceCounterCount] = { "cycles", "instructions", "cache misses", "branch misses" };
+    int64_t values[WOPerformanceCounterCount];
+    [self getValues:values];
+    NSMutableArray *parts = [NSMutableArray arrayWithCapacity:WOPerformanceCounterCount];
+    for (unsigned i = 0; i < WOPerformanceCounterCount; i++)
+    {
+        NSString *part = values[i] == WO_PERFORMANCE_COUNTER_UNAVAILABLE ?
+            WO_STRING(@"%s unavailable", names[i]) : WO_STRING(@"%lld %s", (long long)values[i], names[i]);
+        if (i == WOPerformanceCounterInstructions &&
+            values[WOPerformanceCounterCycles] > 0 && values[WOPerformanceCounterInstructions] >= 0)
+            part = WO_STRING(@"%@ (%.2f IPC)", part,
+                             (double)values[WOPerformanceCounterInstructions] / values[WOPerformanceCounterCycles]);
+        [parts addObject:part];
+    }
+    return [parts componentsJoinedByString:@", "];
+}
+
+- (NSDictionary *)counterDictionary
+{
+    int64_t values[WOPerformanceCounterCount];
+    [self getValues:values];
+    NSMutableDictionary *dictionary = [NSMutableDictionary dictionaryWithCapacity:WOPerformanceCounterCount];
+    for (unsigned i = 0; i < WOPerformanceCounterCount; i++)
+    {
+        [dictionary setObject:(values[i] == WO_PERFORMANCE_COUNTER_UNAVAILABLE ?
+                               (id)[NSNull null] : [NSNumber numberWithLongLong:values[i]])
+                       forKey:WOPerformanceCounterKeys[i]];
+    }
+    return dictionary;
+}
+
+#pragma mark -
+#pragma mark Properties
+
+- (BOOL)isAvailable
+{
+    return leader >= 0;
+}
+
+#pragma mark -
+#pragma mark Private methods
+
+//! Reads the whole group at once, so that the values are mutually consistent.
+- (void)getValues:(int64_t *)values
+{
+    for (unsigned i = 0; i < WOPerformanceCounterCount; i++)
+        values[i] = WO_PERFORMANCE_COUNTER_UNAVAILABLE;
+    if (leader < 0)
+        return;
+
+    // read format: count, time enabled, time running, then one value per member
+    uint64_t buffer[3 + WOPerformanceCounterCount];
+    ssize_t length = read(leader, buffer, sizeof(buffer));
+    if (length < (ssize_t)((3 + openCount) * sizeof(uint64_t)))
+        return;
+    uint64_t enabled = buffer[1];
+    uint64_t running = buffer[2];
+    if (running == 0 && enabled != 0)   // enabled but never scheduled onto the PMU
+        return;
+    for (unsigned i = 0; i < WOPerformanceCounterCount; i++)
+    {
+        if (descriptors[i] < 0)
+            continue;
+        uint64_t value = buffer[3 + positions[i]];
+        values[i] = (running == enabled) ? (int64_t)value : (int64_t)((double)value * enabled / running);
+    }
+}
+
+@end
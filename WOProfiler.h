@@ -0,0 +1,154 @@
+// WOProfiler.h
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// superclass header
+#import "WOObject.h"
+
+// system headers
+#import <pthread.h>     /* pthread_key_t, pthread_mutex_t */
+
+// other headers
+#import "WOUsageMeter.h"
+
+#pragma mark -
+#pragma mark Type definitions
+
+//! Opaque per-thread recording state; see WOProfiler.m.
+typedef struct WOProfilerThread WOProfilerThread;
+
+//! Records nested, named scopes into a call tree per thread, aggregating the
+//! number of times each path was entered and its total and self time.
+//!
+//! Wall time comes from WOMonotonicNanoseconds(); if #measuresProcessorTime
+//! is set, the calling thread's processor time (WOThreadUsageNanoseconds()) is
+//! recorded as well, at the cost of a system call on every enter and exit.
+//!
+//! Each thread records into its own tree without locking. Nodes are carved out
+//! of per-thread arenas and the scope stack only grows, so once every path has
+//! been seen and the stack has reached its maximum depth (the "warmup")
+//! entering and exiting scopes does not allocate.
+//!
+//! When a thread exits its record is kept, because its tree still counts
+//! towards the exports, and is adopted by the next thread which starts
+//! recording. Memory is therefore bounded by the largest number of threads
+//! which have recorded at the same time, not by the number of threads which
+//! have ever recorded.
+//!
+//! Scope names are compared by pointer first and then by contents, and are
+//! stored without copying: pass string literals, or strings which outlive the
+//! profiler.
+//!
+//! The export methods merge the trees of all threads which have recorded so
+//! far. They can be called at any time, but figures for threads which are
+//! recording concurrently may be slightly out of date.
+@interface WOProfiler : WOObject {
+
+    pthread_key_t       threadKey;
+
+    //! Guards #threads, the list of all per-thread records.
+    pthread_mutex_t     threadsLock;
+    WOProfilerThread    *threads;
+
+    BOOL                measuresProcessorTime;
+}
+
+#pragma mark -
+#pragma mark Class methods
+
++ (WOProfiler *)sharedProfiler;
+
+#pragma mark -
+#pragma mark Recording
+
+//! Pushes the scope \p name onto the calling thread's scope stack.
+- (void)enterScope:(const char *)name;
+
+//! Pops the innermost scope from the calling thread's scope stack, adding the
+//! time elapsed since the matching #enterScope: to it. Raises an
+//! NSInternalInconsistencyException if the stack is empty.
+- (void)exitScope;
+
+//! Zeroes all counts and times, keeping the tree structure (so no allocation
+//! is needed to record the same paths again). Should only be called when no
+//! thread has a scope open.
+- (void)reset;
+
+#pragma mark -
+#pragma mark Export
+
+//! Returns the merged call tree in "folded stacks" format, as consumed by
+//! flamegraph.pl and similar tools: one line per path, with frames separated
+//! by semicolons, followed by a space and the path's self wall time in
+//! nanoseconds.
+- (NSString *)foldedStacks;
+
+//! Returns the merged call tree as a JSON object. Each node has "name",
+//! "count", "total_ns" and "self_ns" members (plus "total_cpu_ns" and
+//! "self_cpu_ns" if #measuresProcessorTime is set) and a "children" array.
+- (NSString *)JSONRepresentation;
+
+#pragma mark -
+#pragma mark Properties
+
+//! Whether to record processor time in addition to wall time; should be set
+//! before recording starts. Defaults to NO.
+@property BOOL measuresProcessorTime;
+
+@end
+
+#pragma mark -
+#pragma mark Functions
+
+//! Equivalent to WOProfiler::enterScope:, without the message send.
+void WOProfilerEnter(WOProfiler *profiler, const char *name);
+
+//! Equivalent to WOProfiler::exitScope, without the message send.
+void WOProfilerExit(WOProfiler *profiler);
+
+//! Cleanup handler used by WO_PROFILE_SCOPE.
+WO_INLINE void WOProfilerScopeCleanup(WOProfiler **profiler)
+{
+    WOProfilerExit(*profiler);
+}
+
+#define _WO_PROFILE_CONCAT(a, b)    a ## b
+#define WO_PROFILE_CONCAT(a, b)     _WO_PROFILE_CONCAT(a, b)
+
+//! Enters the scope \p name and exits it automatically when the enclosing C
+//! block ends (including via return, break or goto, but not when an exception
+//! unwinds through it).
+//!
+//! \code
+//! - (void)loadFile:(NSString *)path
+//! {
+//!     WO_PROFILE_SCOPE([WOProfiler sharedProfiler], "loadFile");
+//!     ...
+//! }
+//! \endcode
+#define WO_PROFILE_SCOPE(profiler, name)                                                                \
+    WOProfiler *WO_PROFILE_CONCAT(_WOProfileScope, __LINE__)                                            \
+        __attribute__((cleanup(WOProfilerScopeCleanup), unused)) = (profiler);                          \
+    WOProfilerEnter(WO_PROFILE_CONCAT(_WOProfileScope, __LINE__), (name))
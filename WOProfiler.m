@@ -0,0 +1,462 @@
+// WOProfiler.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOProfiler.h"
+
+// system headers
+#import <libkern/OSAtomic.h>    /* OSAtomicCompareAndSwap32Barrier() */
+#import <string.h>              /* strcmp() */
+
+// macro headers
+#import "WOConvenienceMacros.h"
+#import "WOMemoryBarrier.h"
+
+// other headers
+#import "WOMemory.h"
+
+#pragma mark -
+#pragma mark Macros
+
+//! Number of nodes allocated at a time for each thread's tree.
+#define WO_PROFILER_CHUNK_NODES         128
+
+//! Initial depth of each thread's scope stack (doubled as needed).
+#define WO_PROFILER_INITIAL_DEPTH       32
+
+#pragma mark -
+#pragma mark Type definitions
+
+typedef struct WOProfilerNode WOProfilerNode;
+
+//! One path in a thread's call tree. Children are prepended to the parent's
+//! list only once fully initialized, so exporting threads can walk a tree
+//! while its owner is adding to it.
+struct WOProfilerNode {
+    const char      *name;
+    WOProfilerNode  *parent;
+    WOProfilerNode  * volatile firstChild;
+    WOProfilerNode  *nextSibling;
+    uint64_t        count;
+    WONanoseconds   totalWall;
+    WONanoseconds   childWall;      //!< sum of children's totalWall, for self time
+    WONanoseconds   totalCPU;
+    WONanoseconds   childCPU;
+};
+
+typedef struct WOProfilerChunk {
+    struct WOProfilerChunk  *next;
+    WOProfilerNode          nodes[WO_PROFILER_CHUNK_NODES];
+} WOProfilerChunk;
+
+//! An open scope on a thread's stack.
+typedef struct WOProfilerFrame {
+    WOProfilerNode  *node;
+    WONanoseconds   startWall;
+    WONanoseconds   startCPU;
+} WOProfilerFrame;
+
+struct WOProfilerThread {
+    WOProfilerThread    *next;      //!< in the profiler's list of threads
+    WOProfilerNode      root;       //!< unnamed; its children are the outermost scopes
+    WOProfilerFrame     *frames;
+    unsigned            depth;
+    unsigned            capacity;
+    WOProfilerChunk     *chunks;
+    unsigned            chunkUsed;  //!< nodes used in the head of #chunks
+    volatile int32_t    idle;       //!< set once the owning thread has exited
+};
+
+#pragma mark -
+#pragma mark Static variables
+
+static WOProfiler *WOSharedProfiler = nil;
+
+#pragma mark -
+#pragma mark Static functions
+
+//! Destructor for the profiler's thread key. The record (and its tree, which
+//! still counts towards the exported figures) is kept and handed to the next
+//! thread which starts recording, so threads which come and go (such as GCD
+//! workers) do not make the list grow without bound.
+static void WOProfilerThreadExited(void *value)
+{
+    WOProfilerThread *thread = value;
+    thread->depth = 0;  // scopes left open by the exiting thread are discarded
+    OSAtomicCompareAndSwap32Barrier(0, 1, &thread->idle);
+}
+
+static WOProfilerNode *WOProfilerNewNode(WOProfilerThread *thread)
+{
+    if (!thread->chunks || thread->chunkUsed == WO_PROFILER_CHUNK_NODES)
+    {
+        WOProfilerChunk *chunk  = emalloc(sizeof(WOProfilerChunk));
+        chunk->next             = thread->chunks;
+        thread->chunks          = chunk;
+        thread->chunkUsed       = 0;
+    }
+    WOProfilerNode *node = &thread->chunks->nodes[thread->chunkUsed++];
+    memset(node, 0, sizeof(WOProfilerNode));
+    return node;
+}
+
+static WOProfilerNode *WOProfilerChild(WOProfilerThread *thread, WOProfilerNode *parent, const char *name)
+{
+    for (WOProfilerNode *child = parent->firstChild; child; child = child->nextSibling)
+        if (child->name == name || strcmp(child->name, name) == 0)
+            return child;
+
+    // first visit to this path
+    WOProfilerNode *child   = WOProfilerNewNode(thread);
+    child->name             = name;
+    child->parent           = parent;
+    child->nextSibling      = parent->firstChild;
+    WO_WRITE_MEMORY_BARRIER();
+    parent->firstChild      = child;
+    return child;
+}
+
+static void WOProfilerResetNode(WOProfilerNode *node)
+{
+    node->count     = 0;
+    node->totalWall = node->childWall = 0;
+    node->totalCPU  = node->childCPU = 0;
+    for (WOProfilerNode *child = node->firstChild; child; child = child->nextSibling)
+        WOProfilerResetNode(child);
+}
+
+#pragma mark -
+#pragma mark Export helpers
+
+//! Merges a thread's subtree into a tree of mutable dictionaries keyed by
+//! "name", "count", "total_ns", "self_ns", "total_cpu_ns", "self_cpu_ns" and
+//! "children" (itself a dictionary of merged nodes keyed by name).
+static void WOProfilerMerge(WOProfilerNode *node, NSMutableDictionary *merged)
+{
+    NSMutableDictionary *children = [merged objectForKey:@"children"];
+    for (WOProfilerNode *child = node->firstChild; child; child = child->nextSibling)
+    {
+        NSString            *name   = [NSString stringWithUTF8String:child->name];
+        NSMutableDictionary *target = [children objectForKey:name];
+        if (!target)
+        {
+            target = [NSMutableDictionary dictionaryWithObjectsAndKeys:
+                      name,                                 @"name",
+                      [NSMutableDictionary dictionary],     @"children",
+                      nil];
+            [children setObject:target forKey:name];
+        }
+        uint64_t        count       = child->count + [[target objectForKey:@"count"] unsignedLongLongValue];
+        WONanoseconds   totalWall   = child->totalWall + [[target objectForKey:@"total_ns"] longLongValue];
+        WONanoseconds   selfWall    = child->totalWall - child->childWall + [[target objectForKey:@"self_ns"] longLongValue];
+        WONanoseconds   totalCPU    = child->totalCPU + [[target objectForKey:@"total_cpu_ns"] longLongValue];
+        WONanoseconds   selfCPU     = child->totalCPU - child->childCPU + [[target objectForKey:@"self_cpu_ns"] longLongValue];
+        [target setObject:[NSNumber numberWithUnsignedLongLong:count] forKey:@"count"];
+        [target setObject:[NSNumber numberWithLongLong:totalWall] forKey:@"total_ns"];
+        [target setObject:[NSNumber numberWithLongLong:selfWall] forKey:@"self_ns"];
+        [target setObject:[NSNumber numberWithLongLong:totalCPU] forKey:@"total_cpu_ns"];
+        [target setObject:[NSNumber numberWithLongLong:selfCPU] forKey:@"self_cpu_ns"];
+        WOProfilerMerge(child, target);
+    }
+}
+
+//! Returns the children of a merged node, most expensive first.
+static NSArray *WOProfilerSortedChildren(NSDictionary *merged)
+{
+    NSSortDescriptor *descriptor = [[NSSortDescriptor alloc] initWithKey:@"total_ns" ascending:NO];
+    return [[[merged objectForKey:@"children"] allValues] sortedArrayUsingDescriptors:WO_ARRAY(descriptor)];
+}
+
+static void WOProfilerAppendFolded(NSDictionary *merged, NSString *prefix, NSMutableString *output)
+{
+    for (NSDictionary *child in WOProfilerSortedChildren(merged))
+    {
+        // semicolons and spaces are separators in this format
+        NSString *name = [child objectForKey:@"name"];
+        name = [name stringByReplacingOccurrencesOfString:@";" withString:@":"];
+        name = [name stringByReplacingOccurrencesOfString:@" " withString:@"_"];
+        NSString *path = prefix ? WO_STRING(@"%@;%@", prefix, name) : name;
+        long long selfWall = [[child objectForKey:@"self_ns"] longLongValue];
+        if (selfWall > 0)
+            [output appendFormat:@"%@ %lld\n", path, selfWall];
+        WOProfilerAppendFolded(child, path, output);
+    }
+}
+
+static NSString *WOProfilerJSONString(NSString *string)
+{
+    NSMutableString *escaped = [NSMutableString stringWithString:@"\""];
+    NSUInteger length = [string length];
+    for (NSUInteger i = 0; i < length; i++)
+    {
+        unichar c = [string characterAtIndex:i];
+        if (c == '"' || c == '\\')
+            [escaped appendFormat:@"\\%C", c];
+        else if (c < 0x20)
+            [escaped appendFormat:@"\\u%04x", (unsigned)c];
+        else
+            [escaped appendFormat:@"%C", c];
+    }
+    [escaped appendString:@"\""];
+    return escaped;
+}
+
+static void WOProfilerAppendJSON(NSDictionary *merged, BOOL processorTime, NSMutableString *output)
+{
+    [output appendFormat:@"{\"name\":%@,\"count\":%llu,\"total_ns\":%lld,\"self_ns\":%lld",
+     WOProfilerJSONString([merged objectForKey:@"name"]),
+     [[merged objectForKey:@"count"] unsignedLongLongValue],
+     [[merged objectForKey:@"total_ns"] longLongValue],
+     [[merged objectForKey:@"self_ns"] longLongValue]];
+    if (processorTime)
+        [output appendFormat:@",\"total_cpu_ns\":%lld,\"self_cpu_ns\":%lld",
+         [[merged objectForKey:@"total_cpu_ns"] longLongValue],
+         [[merged objectForKey:@"self_cpu_ns"] longLongValue]];
+    [output appendString:@",\"children\":["];
+    BOOL first = YES;
+    for (NSDictionary *child in WOProfilerSortedChildren(merged))
+    {
+        if (!first)
+            [output appendString:@","];
+        first = NO;
+        WOProfilerAppendJSON(child, processorTime, output);
+    }
+    [output appendString:@"]}"];
+}
+
+@interface WOProfiler ()
+
+- (WOProfilerThread *)currentThread;
+- (NSMutableDictionary *)mergedTree;
+
+@end
+
+@implementation WOProfiler
+
+#pragma mark -
+#pragma mark Class methods
+
++ (WOProfiler *)sharedProfiler
+{
+    WOProfiler *profiler = WOSharedProfiler;
+    WO_READ_MEMORY_BARRIER();
+    if (!profiler)
+    {
+        @synchronized (self)
+        {
+            profiler = WOSharedProfiler;
+            if (!profiler)
+            {
+                profiler = [[self alloc] init];
+                WO_WRITE_MEMORY_BARRIER();
+                WOSharedProfiler = profiler;
+            }
+        }
+    }
+    return profiler;
+}
+
+#pragma mark -
+#pragma mark NSObject overrides
+
+- (id)init
+{
+    if ((self = [super init]))
+    {
+        if (pthread_key_create(&threadKey, WOProfilerThreadExited) != 0)
+            return nil;
+        pthread_mutex_init(&threadsLock, NULL);
+    }
+    return self;
+}
+
+- (void)finalize
+{
+    pthread_key_delete(threadKey);
+    pthread_mutex_destroy(&threadsLock);
+    while (threads)
+    {
+        WOProfilerThread *thread = threads;
+        threads = thread->next;
+        while (thread->chunks)
+        {
+            WOProfilerChunk *chunk = thread->chunks;
+            thread->chunks = chunk->next;
+            free(chunk);
+        }
+        free(thread->frames);
+        free(thread);
+    }
+    [super finalize];
+}
+
+#pragma mark -
+#pragma mark Recording
+
+- (void)enterScope:(const char *)name
+{
+    WOProfilerEnter(self, name);
+}
+
+- (void)exitScope
+{
+    WOProfilerExit(self);
+}
+
+- (void)reset
+{
+    pthread_mutex_lock(&threadsLock);
+    for (WOProfilerThread *thread = threads; thread; thread = thread->next)
+        WOProfilerResetNode(&thread->root);
+    pthread_mutex_unlock(&threadsLock);
+}
+
+#pragma mark -
+#pragma mark Export
+
+- (NSString *)foldedStacks
+{
+    NSMutableString *output = [NSMutableString string];
+    WOProfilerAppendFolded([self mergedTree], nil, output);
+    return output;
+}
+
+- (NSString *)JSONRepresentation
+{
+    NSMutableDictionary *merged = [self mergedTree];
+
+    // root totals are the sums of the outermost scopes
+    uint64_t        count       = 0;
+    WONanoseconds   totalWall   = 0;
+    WONanoseconds   totalCPU    = 0;
+    for (NSDictionary *child in [[merged objectForKey:@"children"] allValues])
+    {
+        count       += [[child objectForKey:@"count"] unsignedLongLongValue];
+        totalWall   += [[child objectForKey:@"total_ns"] longLongValue];
+        totalCPU    += [[child objectForKey:@"total_cpu_ns"] longLongValue];
+    }
+    [merged setObject:@"root" forKey:@"name"];
+    [merged setObject:[NSNumber numberWithUnsignedLongLong:count] forKey:@"count"];
+    [merged setObject:[NSNumber numberWithLongLong:totalWall] forKey:@"total_ns"];
+    [merged setObject:[NSNumber numberWithLongLong:0] forKey:@"self_ns"];
+    [merged setObject:[NSNumber numberWithLongLong:totalCPU] forKey:@"total_cpu_ns"];
+    [merged setObject:[NSNumber numberWithLongLong:0] forKey:@"self_cpu_ns"];
+
+    NSMutableString *output = [NSMutableString string];
+    WOProfilerAppendJSON(merged, measuresProcessorTime, output);
+    return output;
+}
+
+#pragma mark -
+#pragma mark Private methods
+
+//! Returns the calling thread's record, adopting the record of an exited
+//! thread or else creating one on first use.
+- (WOProfilerThread *)currentThread
+{
+    WOProfilerThread *thread = pthread_getspecific(threadKey);
+    if (!thread)
+    {
+        pthread_mutex_lock(&threadsLock);
+        for (thread = threads; thread; thread = thread->next)
+            if (thread->idle && OSAtomicCompareAndSwap32Barrier(1, 0, &thread->idle))
+                break;
+        if (!thread)
+        {
+            thread              = xcalloc(1, sizeof(WOProfilerThread));
+            thread->capacity    = WO_PROFILER_INITIAL_DEPTH;
+            thread->frames      = emalloc(thread->capacity * sizeof(WOProfilerFrame));
+            thread->next        = threads;
+            threads             = thread;
+        }
+        pthread_mutex_unlock(&threadsLock);
+        pthread_setspecific(threadKey, thread);
+    }
+    return thread;
+}
+
+- (NSMutableDictionary *)mergedTree
+{
+    NSMutableDictionary *merged = [NSMutableDictionary dictionaryWithObject:[NSMutableDictionary dictionary]
+                                                                     forKey:@"children"];
+    pthread_mutex_lock(&threadsLock);
+    for (WOProfilerThread *thread = threads; thread; thread = thread->next)
+        WOProfilerMerge(&thread->root, merged);
+    pthread_mutex_unlock(&threadsLock);
+    return merged;
+}
+
+#pragma mark -
+#pragma mark Properties
+
+@synthesize measuresProcessorTime;
+
+#pragma mark -
+#pragma mark Functions
+
+// defined within the implementation for direct access to the profiler's instance variables
+void WOProfilerEnter(WOProfiler *profiler, const char *name)
+{
+    WOProfilerThread *thread = pthread_getspecific(profiler->threadKey);
+    if (!thread)
+        thread = [profiler currentThread];
+    if (thread->depth == thread->capacity)
+    {
+        // grows geometrically, so only during warmup
+        WOProfilerFrame *frames = emalloc(2 * thread->capacity * sizeof(WOProfilerFrame));
+        memcpy(frames, thread->frames, thread->capacity * sizeof(WOProfilerFrame));
+        free(thread->frames);
+        thread->frames      = frames;
+        thread->capacity    *= 2;
+    }
+    WOProfilerNode  *parent = thread->depth ? thread->frames[thread->depth - 1].node : &thread->root;
+    WOProfilerFrame *frame  = &thread->frames[thread->depth++];
+    frame->node             = WOProfilerChild(thread, parent, name);
+    frame->startCPU         = profiler->measuresProcessorTime ? WOThreadUsageNanoseconds() : 0;
+    frame->startWall        = WOMonotonicNanoseconds();
+}
+
+void WOProfilerExit(WOProfiler *profiler)
+{
+    WONanoseconds       now     = WOMonotonicNanoseconds();
+    WOProfilerThread    *thread = pthread_getspecific(profiler->threadKey);
+    if (!thread || thread->depth == 0)
+        [NSException raise:NSInternalInconsistencyException format:@"WOProfilerExit called with no open scope"];
+    WOProfilerFrame     *frame  = &thread->frames[--thread->depth];
+    WOProfilerNode      *node   = frame->node;
+    WONanoseconds       wall    = now - frame->startWall;
+    node->count++;
+    node->totalWall             += wall;
+    node->parent->childWall     += wall;
+    if (profiler->measuresProcessorTime)
+    {
+        WONanoseconds cpu       = WOThreadUsageNanoseconds() - frame->startCPU;
+        node->totalCPU          += cpu;
+        node->parent->childCPU  += cpu;
+    }
+}
+
+@end
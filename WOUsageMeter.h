@@ -27,32 +27,144 @@
 #import "WOObject.h"
 #import <sys/time.h>            /* timeval */
 #import <sys/resource.h>        /* rusage */
+#import <stdint.h>              /* int64_t */
+
+//! A signed duration or timestamp in nanoseconds
+typedef int64_t WONanoseconds;
+
+#define WO_NANOSECONDS_PER_SECOND       1000000000LL
+#define WO_NANOSECONDS_PER_MICROSECOND  1000LL
+
+//! Resource counters from getrusage(), accumulated over the intervals a meter
+//! has been running
+//!
+//! Faults separate memory effects (minor faults: page reclaims such as first
+//! touches of mapped file pages already in the buffer cache; major faults:
+//! pages which had to be read from disk) while context switches separate
+//! waiting (voluntary: blocking on I/O or locks) from contention for the
+//! processor (involuntary: preemption).
+typedef struct WOUsageCounters {
+
+    int64_t minorFaults;                    //!< ru_minflt
+    int64_t majorFaults;                    //!< ru_majflt
+    int64_t voluntaryContextSwitches;       //!< ru_nvcsw
+    int64_t involuntaryContextSwitches;     //!< ru_nivcsw
+    int64_t blockInputOperations;           //!< ru_inblock
+    int64_t blockOutputOperations;          //!< ru_oublock
+
+    //! Peak resident set size of the process in bytes, as of the latest sample
+    //! (ru_maxrss is a high-water mark, so this is not a difference)
+    int64_t maximumResidentSetSize;
+
+} WOUsageCounters;
+
+//! Selects whose processor usage a WOUsageMeter measures
+typedef enum WOUsageMeterScope {
+
+    //! Usage of the whole process (all threads), as reported by getrusage(RUSAGE_SELF)
+    WOUsageMeterProcessScope    = 0,
+
+    //! Usage of only those threads which resume and pause the meter, and only between those calls
+    WOUsageMeterThreadScope     = 1
+
+} WOUsageMeterScope;
+
+//! Maximum number of threads on which a single thread-scoped meter may be running at once
+#define WO_USAGE_METER_MAX_THREADS  64
+
+struct WOUsageMeterThread;
 
 @interface WOUsageMeter : WOObject {
 
+    //! Whose usage is being measured
+    WOUsageMeterScope           _scope;
+
+    //! Per-thread start times and pause counts (thread-scoped meters only)
+    struct WOUsageMeterThread   *_threads;
+
+    //! Sequence lock guarding the fields below: odd while an update is in
+    //! progress; readers retry if it is odd or changes while they copy
+    volatile int32_t        _sequence;
+
     //! Last known usage statistics (at time receiver was put in motion)
-    struct rusage   _last;
+    volatile WONanoseconds  _lastUser;
+    volatile WONanoseconds  _lastSystem;
+    volatile WONanoseconds  _lastWall;
 
-    //! Cumulative total of processor usage
-    struct rusage   _cumulative;
+    //! Cumulative totals of processor usage and elapsed wall time
+    volatile WONanoseconds  _cumulativeUser;
+    volatile WONanoseconds  _cumulativeSystem;
+    volatile WONanoseconds  _cumulativeWall;
 
-    //! Thread-safe
-    int32_t         _pauseCount;
+    //! Resource counters at time receiver was put in motion, and cumulative
+    WOUsageCounters         _lastCounters;
+    WOUsageCounters         _cumulativeCounters;
+
+    //! Thread-safe (process-scoped meters only)
+    volatile int32_t        _pauseCount;
 }
 
 #pragma mark -
-#pragma mark Custom methods
+#pragma mark Creation
 
-//! Returns a usage meter object in "running" state
+//! Returns a process-scoped usage meter object in "running" state
 + (WOUsageMeter *)usageMeter;
 
+//! Returns a thread-scoped usage meter object, running on the calling thread
++ (WOUsageMeter *)threadUsageMeter;
+
+//! Designated initializer; the returned meter is running on the calling thread
+//!
+//! Thread-scoped meters sample the processor usage of the calling thread
+//! only (thread_info() on Darwin, getrusage(RUSAGE_THREAD) on Linux), so
+//! other busy threads in the process do not inflate the figures. Each thread
+//! has its own stackable pause count: a -resume on one thread starts timing
+//! that thread, and only a balancing -pause on the same thread stops it.
+//! A thread holds one of the meter's WO_USAGE_METER_MAX_THREADS entries only
+//! while the meter is running on it, and readers never claim one; raises an
+//! NSInternalInconsistencyException if more threads than that have the meter
+//! running at once. A thread must pause the meter before it exits, otherwise
+//! its entry stays claimed (and may be inherited by a later thread which is
+//! given the same pthread_t).
+- (id)initWithScope:(WOUsageMeterScope)aScope;
+
+#pragma mark -
+#pragma mark Overhead
+
+//! Measures the average cost in nanoseconds of one -pause/-resume pair on a
+//! meter of the given scope, so that it can be subtracted from or reported
+//! alongside measurements
+//!
+//! When \p nested is YES the pair runs inside an outer -resume, so neither
+//! call changes the running state; this is the atomics-only path used by
+//! stacked meters. When NO each call starts or stops the meter and the cost
+//! is dominated by sampling processor usage (getrusage() or thread_info()).
++ (WONanoseconds)overheadForScope:(WOUsageMeterScope)aScope nested:(BOOL)nested;
+
+#pragma mark -
+#pragma mark Custom methods
+
 //! Stackable (can send multiple pause messages)
+//!
+//! Neither -pause, -resume nor any of the readout methods take a lock: the
+//! pause count is maintained with atomic operations and only the calls that
+//! actually start or stop the meter update the totals, under a sequence lock.
+//! Readers never block writers; they simply retry if an update overlapped
+//! their copy.
+//!
+//! For thread-scoped meters the pause count is per-thread, and the interval
+//! ending on the calling thread is added to the cumulative total.
 - (void)pause;
 
 //! Stackable (can send multiple resume messages)
 - (void)resume;
 
 //! Cumulative total processor usage (equivalent to system plus user processor usage)
+//!
+//! For thread-scoped meters this is the sum of all completed intervals on
+//! all threads, plus the interval currently in progress on the calling
+//! thread; intervals in progress on other threads are not included until
+//! those threads pause the meter.
 - (struct timeval)usage;
 
 //! Cumulative system processor usage
@@ -61,14 +173,87 @@
 //! Cumulative user processor usage
 - (struct timeval)userUsage;
 
-//! Returns string of form: "x.xxxxxx/y.yyyyyy/z.zzzzzz (user/system/total)"
+//! Returns string of form: "x.xxxxxx/y.yyyyyy/z.zzzzzz (user/system/total),
+//! a/b faults (minor/major), c/d switches (voluntary/involuntary), e/f blocks
+//! (in/out), g bytes peak RSS"
 - (NSString *)usageString;
 
+//! Cumulative resource counters
+//!
+//! Thread-scoped meters count only the calling threads' events where the
+//! system can attribute them to threads (getrusage(RUSAGE_THREAD) on Linux);
+//! on Darwin the counters of thread-scoped meters are those of the whole
+//! process over the same intervals.
+- (WOUsageCounters)counters;
+
+//! Returns all cumulative figures, as NSNumbers keyed by "userNanoseconds",
+//! "systemNanoseconds", "wallNanoseconds" and the names of the
+//! WOUsageCounters fields
+- (NSDictionary *)usageDictionary;
+
+#pragma mark -
+#pragma mark Nanosecond readout
+
+//! Cumulative total processor usage in nanoseconds
+//!
+//! The underlying sources only have microsecond resolution (getrusage(),
+//! thread_info()), but totals are kept in nanoseconds so that they can be
+//! combined with wall time without conversion.
+- (WONanoseconds)usageNanoseconds;
+
+//! Cumulative system processor usage in nanoseconds
+- (WONanoseconds)systemNanoseconds;
+
+//! Cumulative user processor usage in nanoseconds
+- (WONanoseconds)userNanoseconds;
+
+//! Cumulative elapsed wall time in nanoseconds, measured with the monotonic
+//! clock over the same intervals as processor usage
+//!
+//! For thread-scoped meters the intervals of each thread are summed, so
+//! concurrent threads can accumulate more wall time than actually elapsed.
+- (WONanoseconds)wallNanoseconds;
+
+#pragma mark -
+#pragma mark Properties
+
+@property(readonly) WOUsageMeterScope scope;
+
 @end
 
 #pragma mark -
 #pragma mark Functions
 
+//! Returns the current value of a monotonic clock in nanoseconds
+//!
+//! Uses mach_absolute_time() on Darwin and clock_gettime(CLOCK_MONOTONIC)
+//! elsewhere; neither enters the kernel, so reads take a few tens of
+//! nanoseconds. The origin is arbitrary (typically boot time): only
+//! differences between readings are meaningful.
+WONanoseconds WOMonotonicNanoseconds(void);
+
+//! Returns the processor time (user plus system) consumed so far by the
+//! calling thread, in nanoseconds
+//!
+//! This is the source used by thread-scoped meters; it costs a system call,
+//! so it is considerably more expensive than WOMonotonicNanoseconds().
+WONanoseconds WOThreadUsageNanoseconds(void);
+
+//! Converts a nanosecond duration to a timeval (truncating to microseconds)
+WO_INLINE struct timeval WONanosecondsToTimeval(WONanoseconds nanoseconds)
+{
+    struct timeval time;
+    time.tv_sec     = (time_t)(nanoseconds / WO_NANOSECONDS_PER_SECOND);
+    time.tv_usec    = (suseconds_t)((nanoseconds % WO_NANOSECONDS_PER_SECOND) / WO_NANOSECONDS_PER_MICROSECOND);
+    return time;
+}
+
+//! Converts a timeval to a nanosecond duration; the timeval need not be normalized
+WO_INLINE WONanoseconds WOTimevalToNanoseconds(struct timeval time)
+{
+    return (WONanoseconds)time.tv_sec * WO_NANOSECONDS_PER_SECOND + (WONanoseconds)time.tv_usec * WO_NANOSECONDS_PER_MICROSECOND;
+}
+
 //! Returns difference between two timevals
 //!
 //! Subtracts time interval \p a from time interval \b
@@ -28,10 +28,20 @@
 #import "WOUsageMeter.h"
 
 // system headers
-#import <libkern/OSAtomic.h>    /* OSAtomicIncrement32Barrier, OSAtomicDecrement32Barrier */
+#import <libkern/OSAtomic.h>    /* OSAtomicCompareAndSwap32Barrier, OSAtomicIncrement32Barrier, OSAtomicDecrement32Barrier, OSAtomicCompareAndSwapPtrBarrier */
+#import <pthread.h>             /* pthread_self() */
+#import <time.h>                /* clock_gettime() */
+#ifdef __APPLE__
+#import <dispatch/dispatch.h>   /* dispatch_once() */
+#import <mach/mach.h>           /* thread_info() */
+#import <mach/mach_time.h>      /* mach_absolute_time() */
+#endif
 
 // WOCommon other headers
 #import "WOConvenienceMacros.h"
+#import "WODebugMacros.h"
+#import "WOMemory.h"
+#import "WOMemoryBarrier.h"
 
 #pragma mark -
 #pragma mark Macro definitions
@@ -39,6 +49,157 @@
 // Minimize the risk of undetected typing errors by using a macro instead of a literal constant
 #define WO_ONE_MILLION  1000000
 
+#pragma mark -
+#pragma mark Type definitions
+
+//! One reading of processor usage, the monotonic clock and the resource counters
+typedef struct WOUsageSample {
+    WONanoseconds   user;
+    WONanoseconds   system;
+    WONanoseconds   wall;
+    WOUsageCounters counters;
+} WOUsageSample;
+
+//! Bookkeeping for one thread using a thread-scoped meter; once claimed, only the owning thread modifies an entry
+struct WOUsageMeterThread {
+    void * volatile owner;          //!< pthread_self() of the owning thread, or NULL if unclaimed
+    int32_t         pauseCount;     //!< Per-thread pause count
+    WOUsageSample   last;           //!< Usage of owning thread at time meter was put in motion
+};
+
+#pragma mark -
+#pragma mark Static functions
+
+static void WOUsageCountersFromRusage(WOUsageCounters *counters, const struct rusage *usage)
+{
+    counters->minorFaults                   = usage->ru_minflt;
+    counters->majorFaults                   = usage->ru_majflt;
+    counters->voluntaryContextSwitches      = usage->ru_nvcsw;
+    counters->involuntaryContextSwitches    = usage->ru_nivcsw;
+    counters->blockInputOperations          = usage->ru_inblock;
+    counters->blockOutputOperations         = usage->ru_oublock;
+#ifdef __APPLE__
+    counters->maximumResidentSetSize        = usage->ru_maxrss;         // bytes
+#else
+    counters->maximumResidentSetSize        = usage->ru_maxrss * 1024;  // kilobytes
+#endif
+}
+
+//! Adds the counter differences between \p last and \p now to \p total
+WO_INLINE void WOUsageCountersAccumulate(WOUsageCounters *total, const WOUsageCounters *now, const WOUsageCounters *last)
+{
+    total->minorFaults                  += now->minorFaults - last->minorFaults;
+    total->majorFaults                  += now->majorFaults - last->majorFaults;
+    total->voluntaryContextSwitches     += now->voluntaryContextSwitches - last->voluntaryContextSwitches;
+    total->involuntaryContextSwitches   += now->involuntaryContextSwitches - last->involuntaryContextSwitches;
+    total->blockInputOperations         += now->blockInputOperations - last->blockInputOperations;
+    total->blockOutputOperations        += now->blockOutputOperations - last->blockOutputOperations;
+    total->maximumResidentSetSize       = MAX(total->maximumResidentSetSize, now->maximumResidentSetSize);
+}
+
+//! Samples the user and system processor usage of the process or of the calling thread, and the monotonic clock;
+//! also samples the resource counters if \p counters is YES
+static void WOUsageMeterSample(WOUsageMeterScope scope, WOUsageSample *sample, BOOL counters)
+{
+    struct rusage usage;
+    sample->wall = WOMonotonicNanoseconds();
+    if (scope == WOUsageMeterThreadScope)
+    {
+#if defined(__APPLE__)
+        // pthread_mach_thread_np() does not add a port reference (unlike mach_thread_self())
+        thread_basic_info_data_t    info;
+        mach_msg_type_number_t      count = THREAD_BASIC_INFO_COUNT;
+        if (thread_info(pthread_mach_thread_np(pthread_self()), THREAD_BASIC_INFO, (thread_info_t)&info, &count) == KERN_SUCCESS)
+        {
+            sample->user    = (WONanoseconds)info.user_time.seconds * WO_NANOSECONDS_PER_SECOND +
+                              (WONanoseconds)info.user_time.microseconds * WO_NANOSECONDS_PER_MICROSECOND;
+            sample->system  = (WONanoseconds)info.system_time.seconds * WO_NANOSECONDS_PER_SECOND +
+                              (WONanoseconds)info.system_time.microseconds * WO_NANOSECONDS_PER_MICROSECOND;
+            if (counters && getrusage(RUSAGE_SELF, &usage) == 0)   // no per-thread counters on Darwin
+                WOUsageCountersFromRusage(&sample->counters, &usage);
+            return;
+        }
+#elif defined(RUSAGE_THREAD)
+        if (getrusage(RUSAGE_THREAD, &usage) == 0)
+        {
+            sample->user    = WOTimevalToNanoseconds(usage.ru_utime);
+            sample->system  = WOTimevalToNanoseconds(usage.ru_stime);
+            WOUsageCountersFromRusage(&sample->counters, &usage);
+            return;
+        }
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+        // no user/system split available: attribute everything to user time
+        struct timespec cpu;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu) == 0)
+        {
+            sample->user    = (WONanoseconds)cpu.tv_sec * WO_NANOSECONDS_PER_SECOND + cpu.tv_nsec;
+            sample->system  = 0;
+            if (counters && getrusage(RUSAGE_SELF, &usage) == 0)
+                WOUsageCountersFromRusage(&sample->counters, &usage);
+            return;
+        }
+#endif
+        sample->user = sample->system = 0;
+        memset(&sample->counters, 0, sizeof(sample->counters));
+        return;
+    }
+
+    getrusage(RUSAGE_SELF, &usage);
+    sample->user    = WOTimevalToNanoseconds(usage.ru_utime);
+    sample->system  = WOTimevalToNanoseconds(usage.ru_stime);
+    WOUsageCountersFromRusage(&sample->counters, &usage);
+}
+
+//! Enters the write side of a sequence lock, making the sequence odd
+//!
+//! Writers exclude one another by spinning, but the critical sections only
+//! copy or add a few integers (sampling is always done beforehand).
+WO_INLINE void WOUsageMeterWriteBegin(volatile int32_t *sequence)
+{
+    for (;;)
+    {
+        int32_t current = *sequence;
+        if (!(current & 1) && OSAtomicCompareAndSwap32Barrier(current, current + 1, sequence))
+            return;
+    }
+}
+
+//! Leaves the write side of a sequence lock, making the sequence even again
+WO_INLINE void WOUsageMeterWriteEnd(volatile int32_t *sequence)
+{
+    OSAtomicIncrement32Barrier(sequence);
+}
+
+//! Attempts to increment \p count without taking it from 0 to 1; returns NO
+//! if the count was 0 (or less) and the caller must do a full transition
+WO_INLINE BOOL WOUsageMeterIncrementNested(volatile int32_t *count)
+{
+    int32_t current;
+    while ((current = *count) > 0)
+        if (OSAtomicCompareAndSwap32Barrier(current, current + 1, count))
+            return YES;
+    return NO;
+}
+
+//! Attempts to decrement \p count without taking it from 1 to 0; returns NO
+//! if the count was 1 (or less) and the caller must do a full transition
+WO_INLINE BOOL WOUsageMeterDecrementNested(volatile int32_t *count)
+{
+    int32_t current;
+    while ((current = *count) > 1)
+        if (OSAtomicCompareAndSwap32Barrier(current, current - 1, count))
+            return YES;
+    return NO;
+}
+
+@interface WOUsageMeter ()
+
+- (struct WOUsageMeterThread *)lookUpThread;
+- (struct WOUsageMeterThread *)claimThread;
+- (void)getCumulative:(WOUsageSample *)total;
+
+@end
+
 @implementation WOUsageMeter
 
 #pragma mark -
@@ -46,138 +207,353 @@
 
 - (id)init
 {
+    return [self initWithScope:WOUsageMeterProcessScope];
+}
+
+- (void)finalize
+{
+    free(_threads);
+    [super finalize];
+}
+
+#pragma mark -
+#pragma mark Creation
+
++ (WOUsageMeter *)usageMeter
+{
+    return [[self alloc] init];
+}
+
++ (WOUsageMeter *)threadUsageMeter
+{
+    return [[self alloc] initWithScope:WOUsageMeterThreadScope];
+}
+
+- (id)initWithScope:(WOUsageMeterScope)aScope
+{
+    WOParameterCheck(aScope == WOUsageMeterProcessScope || aScope == WOUsageMeterThreadScope);
     if ((self = [super init]))
     {
-        getrusage(RUSAGE_SELF, &(self->_last));
-        OSAtomicIncrement32Barrier(&(self->_pauseCount));
+        _scope = aScope;
+        if (_scope == WOUsageMeterThreadScope)
+            _threads = xcalloc(WO_USAGE_METER_MAX_THREADS, sizeof(struct WOUsageMeterThread));
+        [self resume];
     }
     return self;
 }
 
 #pragma mark -
-#pragma mark Custom methods
+#pragma mark Overhead
 
-+ (WOUsageMeter *)usageMeter
++ (WONanoseconds)overheadForScope:(WOUsageMeterScope)aScope nested:(BOOL)nested
 {
-    return [[self alloc] init];
+    const unsigned  iterations  = nested ? 100000 : 1000;
+    WOUsageMeter    *meter      = [[self alloc] initWithScope:aScope];
+    if (!nested)
+        [meter pause];
+    WONanoseconds start = WOMonotonicNanoseconds();
+    for (unsigned i = 0; i < iterations; i++)
+    {
+        [meter resume];
+        [meter pause];
+    }
+    return (WONanoseconds)((WOMonotonicNanoseconds() - start) / iterations);
 }
 
+#pragma mark -
+#pragma mark Custom methods
+
 - (void)pause
 {
-    if (OSAtomicDecrement32Barrier(&(_pauseCount)) == 0)    // pause when pause count hits 0
+    if (_scope == WOUsageMeterThreadScope)
     {
-        struct rusage now;
-        getrusage(RUSAGE_SELF, &now);
-        @synchronized (self)
+        // entry is private to this thread, so only the shared totals need protection
+        struct WOUsageMeterThread *thread = [self lookUpThread];
+        WOCheck(thread != NULL && "pause without balancing resume on this thread");
+        if (--thread->pauseCount == 0)  // pause when this thread's pause count hits 0
         {
-            _cumulative.ru_utime = WOAddTimeval(_cumulative.ru_utime, WOSubtractTimeval(_last.ru_utime, now.ru_utime));
-            _cumulative.ru_stime = WOAddTimeval(_cumulative.ru_stime, WOSubtractTimeval(_last.ru_stime, now.ru_stime));
+            WOUsageSample now;
+            WOUsageMeterSample(_scope, &now, YES);
+            WOUsageMeterWriteBegin(&_sequence);
+            _cumulativeUser     += now.user - thread->last.user;
+            _cumulativeSystem   += now.system - thread->last.system;
+            _cumulativeWall     += now.wall - thread->last.wall;
+            WOUsageCountersAccumulate(&_cumulativeCounters, &now.counters, &thread->last.counters);
+            WOUsageMeterWriteEnd(&_sequence);
+
+            // hand the entry back so that idle threads never pin one
+            memset(&thread->last, 0, sizeof(thread->last));
+            OSAtomicCompareAndSwapPtrBarrier(thread->owner, NULL, &thread->owner);
         }
     }
+    else if (!WOUsageMeterDecrementNested(&_pauseCount))
+    {
+        // the 1 to 0 transition only ever happens inside the write section,
+        // so it is ordered with respect to any concurrent resume
+        WOUsageSample now;
+        WOUsageMeterSample(_scope, &now, YES);
+        WOUsageMeterWriteBegin(&_sequence);
+        if (OSAtomicDecrement32Barrier(&_pauseCount) == 0)  // pause when pause count hits 0
+        {
+            _cumulativeUser     += now.user - _lastUser;
+            _cumulativeSystem   += now.system - _lastSystem;
+            _cumulativeWall     += now.wall - _lastWall;
+            WOUsageCountersAccumulate(&_cumulativeCounters, &now.counters, &_lastCounters);
+        }
+        WOUsageMeterWriteEnd(&_sequence);
+    }
 }
 
 - (void)resume
 {
-    if (OSAtomicIncrement32Barrier(&(_pauseCount)) == 1)    // resume when pause count moves from 0 to 1
+    if (_scope == WOUsageMeterThreadScope)
+    {
+        // entry is private to this thread, so no locking required
+        struct WOUsageMeterThread *thread = [self claimThread];
+        if (++thread->pauseCount == 1)  // resume when this thread's pause count moves from 0 to 1
+            WOUsageMeterSample(_scope, &thread->last, YES);
+    }
+    else if (!WOUsageMeterIncrementNested(&_pauseCount))
     {
-        struct rusage now;
-        getrusage(RUSAGE_SELF, &now);
-        @synchronized (self)
+        WOUsageSample now;
+        WOUsageMeterSample(_scope, &now, YES);
+        WOUsageMeterWriteBegin(&_sequence);
+        if (OSAtomicIncrement32Barrier(&_pauseCount) == 1)  // resume when pause count moves from 0 to 1
         {
-            _last = now;
+            _lastUser       = now.user;
+            _lastSystem     = now.system;
+            _lastWall       = now.wall;
+            _lastCounters   = now.counters;
         }
+        WOUsageMeterWriteEnd(&_sequence);
     }
 }
 
 - (struct timeval)usage
 {
-    struct timeval user;
-    struct timeval system;
-    struct rusage now;
-    getrusage(RUSAGE_SELF, &now);
-    @synchronized (self)
-    {
-        if (_pauseCount > 0)    // currently running
-        {
-            user     = WOAddTimeval(_cumulative.ru_utime, WOSubtractTimeval(_last.ru_utime, now.ru_utime));
-            system   = WOAddTimeval(_cumulative.ru_stime, WOSubtractTimeval(_last.ru_stime, now.ru_stime));
-        }
-        else                    // paused
-        {
-            user    = _cumulative.ru_utime;
-            system  = _cumulative.ru_stime;
-        }
-    }
-    return WOAddTimeval(user, system);
+    return WONanosecondsToTimeval([self usageNanoseconds]);
 }
 
 - (struct timeval)systemUsage
 {
-    struct timeval system;
-    struct rusage now;
-    getrusage(RUSAGE_SELF, &now);
-    @synchronized (self)
-    {
-        if (_pauseCount > 0)    // currently running
-            system   = WOAddTimeval(_cumulative.ru_stime, WOSubtractTimeval(_last.ru_stime, now.ru_stime));
-        else                    // paused
-            system  = _cumulative.ru_stime;
-    }
-    return system;
+    return WONanosecondsToTimeval([self systemNanoseconds]);
 }
 
 - (struct timeval)userUsage
 {
-    struct timeval user;
-    struct rusage now;
-    getrusage(RUSAGE_SELF, &now);
-    @synchronized (self)
-    {
-        if (_pauseCount > 0)    // currently running
-            user    = WOAddTimeval(_cumulative.ru_utime, WOSubtractTimeval(_last.ru_utime, now.ru_utime));
-        else                    // paused
-            user    = _cumulative.ru_utime;
-    }
-    return user;
+    return WONanosecondsToTimeval([self userNanoseconds]);
 }
 
 - (NSString *)usageString
 {
     // get usage
-    struct timeval user     = [self userUsage];
-    struct timeval system   = [self systemUsage];
+    WOUsageSample total;
+    [self getCumulative:&total];
+    NSString *counters = WO_STRING(@"%lld/%lld faults (minor/major), %lld/%lld switches (voluntary/involuntary), "
+                                   @"%lld/%lld blocks (in/out), %lld bytes peak RSS",
+                                   (long long)total.counters.minorFaults,
+                                   (long long)total.counters.majorFaults,
+                                   (long long)total.counters.voluntaryContextSwitches,
+                                   (long long)total.counters.involuntaryContextSwitches,
+                                   (long long)total.counters.blockInputOperations,
+                                   (long long)total.counters.blockOutputOperations,
+                                   (long long)total.counters.maximumResidentSetSize);
 
 #ifdef WO_COCOA_SUPPORTS_LONG_DOUBLE
-    // convert to microseconds
-    unsigned long long u = (user.tv_sec * WO_ONE_MILLION) + user.tv_usec;
-    unsigned long long s = (system.tv_sec * WO_ONE_MILLION) + system.tv_usec;
-
     // format output
-    return WO_STRING(@"%.6Lf/%.6Lf/%.6Lf (user/system/total)",
-                     ((long double)u) / WO_ONE_MILLION,
-                     ((long double)s) / WO_ONE_MILLION,
-                     ((long double)(u + s)) / WO_ONE_MILLION);
+    return WO_STRING(@"%.6Lf/%.6Lf/%.6Lf (user/system/total), %@",
+                     ((long double)total.user) / WO_NANOSECONDS_PER_SECOND,
+                     ((long double)total.system) / WO_NANOSECONDS_PER_SECOND,
+                     ((long double)(total.user + total.system)) / WO_NANOSECONDS_PER_SECOND,
+                     counters);
 #else
-    // convert to microseconds
-    unsigned long u = (user.tv_sec * WO_ONE_MILLION) + user.tv_usec;
-    unsigned long s = (system.tv_sec * WO_ONE_MILLION) + system.tv_usec;
-
     // format output
-    return WO_STRING(@"%f/%f/%f (user/system/total)",
-                     ((double)u) / WO_ONE_MILLION,
-                     ((double)s) / WO_ONE_MILLION,
-                     ((double)(u + s)) / WO_ONE_MILLION);
+    return WO_STRING(@"%f/%f/%f (user/system/total), %@",
+                     ((double)total.user) / WO_NANOSECONDS_PER_SECOND,
+                     ((double)total.system) / WO_NANOSECONDS_PER_SECOND,
+                     ((double)(total.user + total.system)) / WO_NANOSECONDS_PER_SECOND,
+                     counters);
 #endif
 }
 
+- (WOUsageCounters)counters
+{
+    WOUsageSample total;
+    [self getCumulative:&total];
+    return total.counters;
+}
+
+- (NSDictionary *)usageDictionary
+{
+    WOUsageSample total;
+    [self getCumulative:&total];
+    return [NSDictionary dictionaryWithObjectsAndKeys:
+            [NSNumber numberWithLongLong:total.user],                                   @"userNanoseconds",
+            [NSNumber numberWithLongLong:total.system],                                 @"systemNanoseconds",
+            [NSNumber numberWithLongLong:total.wall],                                   @"wallNanoseconds",
+            [NSNumber numberWithLongLong:total.counters.minorFaults],                   @"minorFaults",
+            [NSNumber numberWithLongLong:total.counters.majorFaults],                   @"majorFaults",
+            [NSNumber numberWithLongLong:total.counters.voluntaryContextSwitches],      @"voluntaryContextSwitches",
+            [NSNumber numberWithLongLong:total.counters.involuntaryContextSwitches],    @"involuntaryContextSwitches",
+            [NSNumber numberWithLongLong:total.counters.blockInputOperations],          @"blockInputOperations",
+            [NSNumber numberWithLongLong:total.counters.blockOutputOperations],         @"blockOutputOperations",
+            [NSNumber numberWithLongLong:total.counters.maximumResidentSetSize],        @"maximumResidentSetSize",
+            nil];
+}
+
+#pragma mark -
+#pragma mark Nanosecond readout
+
+- (WONanoseconds)usageNanoseconds
+{
+    WOUsageSample total;
+    [self getCumulative:&total];
+    return total.user + total.system;
+}
+
+- (WONanoseconds)systemNanoseconds
+{
+    WOUsageSample total;
+    [self getCumulative:&total];
+    return total.system;
+}
+
+- (WONanoseconds)userNanoseconds
+{
+    WOUsageSample total;
+    [self getCumulative:&total];
+    return total.user;
+}
+
+- (WONanoseconds)wallNanoseconds
+{
+    WOUsageSample total;
+    [self getCumulative:&total];
+    return total.wall;
+}
+
+#pragma mark -
+#pragma mark Private methods
+
+//! Returns the calling thread's entry, or NULL if the meter is not running
+//! on the calling thread; never claims an entry
+- (struct WOUsageMeterThread *)lookUpThread
+{
+    void *owner = (void *)pthread_self();
+    for (unsigned i = 0; i < WO_USAGE_METER_MAX_THREADS; i++)
+        if (_threads[i].owner == owner)
+            return &_threads[i];
+    return NULL;
+}
+
+//! Returns the calling thread's entry, claiming a free one if the meter is not
+//! yet running on the calling thread; entries are released again by -pause
+- (struct WOUsageMeterThread *)claimThread
+{
+    struct WOUsageMeterThread *thread = [self lookUpThread];
+    if (thread)
+        return thread;
+    void *owner = (void *)pthread_self();
+    for (unsigned i = 0; i < WO_USAGE_METER_MAX_THREADS; i++)
+    {
+        thread = &_threads[i];
+        if (!thread->owner && OSAtomicCompareAndSwapPtrBarrier(NULL, owner, &thread->owner))
+            return thread;
+    }
+    WOCheck(NO && "too many threads for thread-scoped usage meter");
+    return NULL;
+}
+
+//! Returns cumulative totals, including the interval in progress (if any)
+- (void)getCumulative:(WOUsageSample *)total
+{
+    WOUsageSample   now;
+    WOUsageSample   last;
+    int32_t         running;
+
+    // sequence lock read side: copy, then retry if a writer was active or intervened
+    for (;;)
+    {
+        int32_t sequence = _sequence;
+        WO_READ_MEMORY_BARRIER();
+        if (sequence & 1)
+            continue;
+
+        // sample only once no write section is open: any resume whose start
+        // time is visible below must then have sampled before this did
+        WOUsageMeterSample(_scope, &now, YES);
+        total->user     = _cumulativeUser;
+        total->system   = _cumulativeSystem;
+        total->wall     = _cumulativeWall;
+        last.user       = _lastUser;
+        last.system     = _lastSystem;
+        last.wall       = _lastWall;
+        last.counters   = _lastCounters;
+        total->counters = _cumulativeCounters;
+        running         = _pauseCount;
+        WO_READ_MEMORY_BARRIER();
+        if (_sequence == sequence)
+            break;
+    }
+
+    if (_scope == WOUsageMeterThreadScope)
+    {
+        // only the calling thread's interval in progress can be sampled; a
+        // thread without an entry is simply not running
+        struct WOUsageMeterThread *thread = [self lookUpThread];
+        running = thread ? thread->pauseCount : 0;
+        if (thread)
+            last = thread->last;
+    }
+
+    if (running > 0)    // currently running
+    {
+        total->user     += now.user - last.user;
+        total->system   += now.system - last.system;
+        total->wall     += now.wall - last.wall;
+        WOUsageCountersAccumulate(&total->counters, &now.counters, &last.counters);
+    }
+}
+
+#pragma mark -
+#pragma mark Properties
+
+@synthesize scope = _scope;
+
 @end
 
 #pragma mark -
 #pragma mark Functions
 
+WONanoseconds WOMonotonicNanoseconds(void)
+{
+#ifdef __APPLE__
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t predicate;
+    dispatch_once(&predicate, ^{
+        mach_timebase_info(&timebase);
+    });
+    uint64_t absolute = mach_absolute_time();
+    if (timebase.numer == timebase.denom)   // nanosecond ticks (Intel): skip the scaling
+        return (WONanoseconds)absolute;
+    return (WONanoseconds)(absolute * timebase.numer / timebase.denom);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (WONanoseconds)now.tv_sec * WO_NANOSECONDS_PER_SECOND + now.tv_nsec;
+#endif
+}
+
+WONanoseconds WOThreadUsageNanoseconds(void)
+{
+    WOUsageSample sample;
+    WOUsageMeterSample(WOUsageMeterThreadScope, &sample, NO);
+    return sample.user + sample.system;
+}
+
 struct timeval WOSubtractTimeval(struct timeval a, struct timeval b)
 {
-    volatile struct timeval difference;
+    struct timeval difference;
     difference.tv_sec   = b.tv_sec - a.tv_sec;
     difference.tv_usec  = b.tv_usec - a.tv_usec;
     return WONormalizeTimeval(difference);
@@ -185,7 +561,7 @@ struct timeval WOSubtractTimeval(struct timeval a, struct timeval b)
 
 struct timeval WOAddTimeval(struct timeval a, struct timeval b)
 {
-    volatile struct timeval total;
+    struct timeval total;
     total.tv_sec    = a.tv_sec + b.tv_sec;
     total.tv_usec   = a.tv_usec + b.tv_usec;
     return WONormalizeTimeval(total);
@@ -193,11 +569,12 @@ struct timeval WOAddTimeval(struct timeval a, struct timeval b)
 
 struct timeval WONormalizeTimeval(struct timeval time)
 {
-    if ((time.tv_usec >= WO_ONE_MILLION) || (time.tv_usec <= WO_ONE_MILLION))       // microseconds overflowed
+    // only divide when the microseconds component has actually overflowed
+    if ((time.tv_usec >= WO_ONE_MILLION) || (time.tv_usec <= -WO_ONE_MILLION))
     {
-        __darwin_time_t overflow    = time.tv_usec / WO_ONE_MILLION;
-        time.tv_sec                 += overflow;
-        time.tv_usec                -= (overflow * WO_ONE_MILLION);
+        time_t overflow = time.tv_usec / WO_ONE_MILLION;
+        time.tv_sec     += overflow;
+        time.tv_usec    -= (overflow * WO_ONE_MILLION);
     }
 
     if ((time.tv_sec > 0) && (time.tv_usec < 0))        // signedness mismatch
@@ -0,0 +1,90 @@
+// WOBenchmark.h
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// system headers
+#import <Foundation/Foundation.h>
+#import <stdint.h>              /* uint64_t */
+
+//! Prepares the fixture for a benchmark case. Called once per case, outside
+//! the timed region; may return nil.
+typedef id (^WOBenchmarkSetUp)(void);
+
+//! Performs \p iterations operations on \p fixture. The harness times whole
+//! invocations and divides by \p iterations, so the body should be nothing
+//! but the loop over the operation being measured.
+typedef void (^WOBenchmarkBody)(id fixture, uint64_t iterations);
+
+//! Registers a benchmark case. Names are "/"-separated paths, conventionally
+//! "suite/variant/case", and are what --filter matches against. Typically
+//! called from a WO_LOAD function in the file which defines the cases, so
+//! that every linked suite is available to WOBenchmarkMain().
+void WOBenchmarkRegister(const char *name, WOBenchmarkSetUp setUp, WOBenchmarkBody body);
+
+//! Registers a benchmark case which processes \p bytesPerOperation bytes per
+//! operation, so that its throughput is reported as well.
+void WOBenchmarkRegisterWithBytes(const char *name, uint64_t bytesPerOperation, WOBenchmarkSetUp setUp,
+                                  WOBenchmarkBody body);
+
+//! Stops the clocks (and the allocation meter) during a benchmark body, for
+//! per-iteration preparation which should not count towards the sample, such
+//! as evicting a file from the page cache. Every call must be balanced by a
+//! call to WOBenchmarkResumeTiming() before the body returns. Each pair costs
+//! a few clock reads, so it suits operations well above a microsecond.
+void WOBenchmarkPauseTiming(void);
+
+//! Restarts the clocks stopped by WOBenchmarkPauseTiming().
+void WOBenchmarkResumeTiming(void);
+
+//! Runs the registered cases selected by the command line \p argv and prints
+//! a table of per-operation timings, returning an exit status. For each case
+//! the harness:
+//!
+//!   - warms up, running the body until the warmup time has elapsed;
+//!   - calibrates the iteration count so that one sample takes at least the
+//!     minimum sample time, which keeps timer resolution and call overhead
+//!     out of the results;
+//!   - takes repeated samples, reporting the minimum, median and median
+//!     absolute deviation (MAD) of wall time per operation, along with the
+//!     median processor time per operation, and the throughput at the median
+//!     for cases registered with a byte count;
+//!   - makes one further pass under a WOAllocationMeter, where supported, to
+//!     report allocations and bytes per operation.
+//!
+//! With --json -, the JSON results are the only thing written to standard
+//! output, so that they can be piped; the table (and any comparison) goes to
+//! standard error instead.
+//!
+//! With --baseline FILE, the results are also compared case by case with a
+//! file previously written by --json. A case has changed significantly only
+//! when the 95% confidence intervals for the two medians do not overlap, and
+//! a significant slowdown larger than --threshold percent is a regression,
+//! making the run exit with status 2. Comparing intervals rather than raw
+//! medians keeps ordinary run-to-run noise from failing the run.
+//!
+//! The median and MAD are used rather than the mean and standard deviation
+//! because benchmark noise is one-sided and heavy-tailed: interrupts,
+//! collections and preemption only ever make a sample slower.
+int WOBenchmarkMain(int argc, char *argv[]);
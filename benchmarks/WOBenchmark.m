@@ -0,0 +1,663 @@
+// WOBenchmark.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// header
+#import "WOBenchmark.h"
+
+// system headers
+#import <getopt.h>              /* getopt_long() */
+#import <math.h>                /* fabs(), sqrt() */
+
+// macro headers
+#import "WOConvenienceMacros.h"
+
+// class headers
+#import "WOAllocationMeter.h"
+#import "WOUsageMeter.h"
+
+#define WO_BENCHMARK_DEFAULT_SAMPLES        10
+#define WO_BENCHMARK_DEFAULT_SAMPLE_TIME    0.05
+#define WO_BENCHMARK_DEFAULT_WARMUP_TIME    0.2
+#define WO_BENCHMARK_MAX_FILTERS            16
+#define WO_BENCHMARK_DEFAULT_THRESHOLD      5.0
+
+//! Exit status when --baseline finds a regression, distinct from
+//! EXIT_FAILURE so scripts can tell a slowdown from a broken run.
+#define WO_BENCHMARK_REGRESSION_STATUS      2
+
+//! Standard normal quantile for the two-sided 95% confidence intervals used
+//! when comparing against a baseline.
+#define WO_BENCHMARK_Z_95                   1.96
+
+//! Upper bound on the growth of the iteration count between calibration runs,
+//! so that one unusually fast run cannot blow the estimate out.
+#define WO_BENCHMARK_MAX_GROWTH             10
+
+#pragma mark -
+#pragma mark Types
+
+@interface WOBenchmarkCase : NSObject {
+
+    NSString        *name;
+    uint64_t        bytesPerOperation;
+    WOBenchmarkSetUp setUp;
+    WOBenchmarkBody body;
+}
+
+@property(readonly) NSString *name;
+@property(readonly) uint64_t bytesPerOperation;
+@property(readonly) WOBenchmarkSetUp setUp;
+@property(readonly) WOBenchmarkBody body;
+
+- (id)initWithName:(NSString *)aName bytesPerOperation:(uint64_t)bytes setUp:(WOBenchmarkSetUp)aSetUp
+              body:(WOBenchmarkBody)aBody;
+
+@end
+
+@implementation WOBenchmarkCase
+
+@synthesize name, bytesPerOperation, setUp, body;
+
+- (id)initWithName:(NSString *)aName bytesPerOperation:(uint64_t)bytes setUp:(WOBenchmarkSetUp)aSetUp
+              body:(WOBenchmarkBody)aBody
+{
+    if ((self = [super init]))
+    {
+        name                = [aName copy];
+        bytesPerOperation   = bytes;
+        setUp               = [aSetUp copy];
+        body                = [aBody copy];
+    }
+    return self;
+}
+
+@end
+
+typedef struct WOBenchmarkOptions {
+
+    unsigned    samples;
+    double      sampleTime;
+    double      warmupTime;
+    const char  *filters[WO_BENCHMARK_MAX_FILTERS];
+    unsigned    filterCount;
+
+    //! Results file to compare against, or NULL.
+    const char  *baselinePath;
+
+    //! Percentage slowdown of the median beyond which a significant change
+    //! fails the run.
+    double      threshold;
+
+} WOBenchmarkOptions;
+
+//! All times are nanoseconds per operation.
+typedef struct WOBenchmarkResult {
+
+    const char  *name;
+    uint64_t    iterations;
+    unsigned    sampleCount;
+    double      *samples;
+    double      minimum;
+    double      median;
+    double      mad;
+
+    //! 95% confidence interval for the median.
+    double      medianLow;
+    double      medianHigh;
+    double      processorMedian;
+
+    //! Zero unless the case was registered with a byte count.
+    uint64_t    bytesPerOperation;
+
+    //! Negative when allocations cannot be counted.
+    double      allocations;
+    double      bytesAllocated;
+
+} WOBenchmarkResult;
+
+#pragma mark -
+#pragma mark Registry
+
+static NSMutableArray *WOBenchmarkCases = nil;
+
+void WOBenchmarkRegister(const char *name, WOBenchmarkSetUp setUp, WOBenchmarkBody body)
+{
+    WOBenchmarkRegisterWithBytes(name, 0, setUp, body);
+}
+
+void WOBenchmarkRegisterWithBytes(const char *name, uint64_t bytesPerOperation, WOBenchmarkSetUp setUp,
+                                  WOBenchmarkBody body)
+{
+    if (!WOBenchmarkCases)
+        WOBenchmarkCases = [[NSMutableArray alloc] init];
+    WOBenchmarkCase *benchmark = [[WOBenchmarkCase alloc] initWithName:[NSString stringWithUTF8String:name]
+                                                     bytesPerOperation:bytesPerOperation
+                                                                 setUp:setUp
+                                                                  body:body];
+    [WOBenchmarkCases addObject:benchmark];
+}
+
+static BOOL WOBenchmarkSelected(WOBenchmarkCase *benchmark, WOBenchmarkOptions *options)
+{
+    if (options->filterCount == 0)
+        return YES;
+    const char *name = [[benchmark name] UTF8String];
+    for (unsigned i = 0; i < options->filterCount; i++)
+        if (strstr(name, options->filters[i]))
+            return YES;
+    return NO;
+}
+
+#pragma mark -
+#pragma mark Measurement
+
+//! Time spent paused during the current run, subtracted from its sample.
+static WONanoseconds WOBenchmarkPausedWall          = 0;
+static WONanoseconds WOBenchmarkPausedProcessor     = 0;
+static WONanoseconds WOBenchmarkPauseWallStart      = 0;
+static WONanoseconds WOBenchmarkPauseProcessorStart = 0;
+
+//! Meter of the allocation pass, if one is in progress.
+static WOAllocationMeter *WOBenchmarkAllocationMeter = nil;
+
+void WOBenchmarkPauseTiming(void)
+{
+    [WOBenchmarkAllocationMeter pause];
+    WOBenchmarkPauseProcessorStart = WOThreadUsageNanoseconds();
+    WOBenchmarkPauseWallStart = WOMonotonicNanoseconds();
+}
+
+void WOBenchmarkResumeTiming(void)
+{
+    WOBenchmarkPausedWall += WOMonotonicNanoseconds() - WOBenchmarkPauseWallStart;
+    WOBenchmarkPausedProcessor += WOThreadUsageNanoseconds() - WOBenchmarkPauseProcessorStart;
+    [WOBenchmarkAllocationMeter resume];
+}
+
+//! Runs \p iterations operations, returning the wall time and, optionally, the
+//! thread's processor time, in nanoseconds.
+static WONanoseconds WOBenchmarkRun(WOBenchmarkBody body, id fixture, uint64_t iterations,
+                                    WONanoseconds *processor)
+{
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    WOBenchmarkPausedWall = WOBenchmarkPausedProcessor = 0;
+    WONanoseconds processorStart = processor ? WOThreadUsageNanoseconds() : 0;
+    WONanoseconds start = WOMonotonicNanoseconds();
+    body(fixture, iterations);
+    [pool drain];   // releasing what the body produced is part of its cost
+    WONanoseconds wall = WOMonotonicNanoseconds() - start - WOBenchmarkPausedWall;
+    if (processor)
+        *processor = WOThreadUsageNanoseconds() - processorStart - WOBenchmarkPausedProcessor;
+    return wall;
+}
+
+//! Returns the iteration count which makes one run last at least
+//! \p sampleTime seconds, spending at least \p warmupTime seconds running.
+static uint64_t WOBenchmarkCalibrate(WOBenchmarkBody body, id fixture, double sampleTime, double warmupTime)
+{
+    WONanoseconds target = (WONanoseconds)(sampleTime * WO_NANOSECONDS_PER_SECOND);
+    WONanoseconds warmup = (WONanoseconds)(warmupTime * WO_NANOSECONDS_PER_SECOND);
+    WONanoseconds spent = 0;
+    uint64_t iterations = 1;
+    for (;;)
+    {
+        WONanoseconds elapsed = WOBenchmarkRun(body, fixture, iterations, NULL);
+        spent += elapsed;
+        if (elapsed >= target)
+        {
+            if (spent >= warmup)
+                return iterations;
+            continue;   // calibrated but still warming up
+        }
+        uint64_t estimate = elapsed > 0 ? (uint64_t)(iterations * 1.2 * target / elapsed) : 0;
+        iterations = MAX(iterations + 1, MIN(estimate, iterations * WO_BENCHMARK_MAX_GROWTH));
+    }
+}
+
+static int WOBenchmarkCompareDoubles(const void *a, const void *b)
+{
+    double left = *(const double *)a, right = *(const double *)b;
+    return left < right ? -1 : left > right ? 1 : 0;
+}
+
+//! Sorts \p values in place and returns their median.
+static double WOBenchmarkMedian(double *values, unsigned count)
+{
+    qsort(values, count, sizeof(double), WOBenchmarkCompareDoubles);
+    return count % 2 ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+//! Returns the distribution-free 95% confidence interval for the median of
+//! the \p count sorted \p values, bounded by the order statistics whose ranks
+//! come from the normal approximation to the binomial distribution. With few
+//! samples the interval widens to the extremes rather than overstating
+//! confidence.
+static void WOBenchmarkMedianInterval(const double *sorted, unsigned count, double *low, double *high)
+{
+    double spread = WO_BENCHMARK_Z_95 * sqrt(count) / 2;
+    long lower = (long)floor(count / 2.0 - spread);
+    long upper = (long)ceil(count / 2.0 + spread) - 1;
+    *low    = sorted[MAX(lower, 0L)];
+    *high   = sorted[MIN(upper, (long)count - 1)];
+}
+
+static WOBenchmarkResult WOBenchmarkMeasure(WOBenchmarkCase *benchmark, WOBenchmarkOptions *options)
+{
+    WOBenchmarkResult result = {
+        .name               = strdup([[benchmark name] UTF8String]),
+        .sampleCount        = options->samples,
+        .bytesPerOperation  = [benchmark bytesPerOperation]
+    };
+    WOBenchmarkBody body = [benchmark body];
+    id fixture = [benchmark setUp] ? [benchmark setUp]() : nil;
+    [[NSGarbageCollector defaultCollector] collectExhaustively];
+
+    uint64_t iterations = WOBenchmarkCalibrate(body, fixture, options->sampleTime, options->warmupTime);
+    double *samples = calloc(options->samples, sizeof(double));
+    double *processor = calloc(options->samples, sizeof(double));
+    for (unsigned i = 0; i < options->samples; i++)
+    {
+        WONanoseconds processorTime;
+        samples[i] = (double)WOBenchmarkRun(body, fixture, iterations, &processorTime) / iterations;
+        processor[i] = (double)processorTime / iterations;
+    }
+    result.iterations       = iterations;
+    result.samples          = samples;
+    result.processorMedian  = WOBenchmarkMedian(processor, options->samples);
+
+    // samples are kept in the order taken; statistics work on a sorted copy
+    double *sorted = malloc(options->samples * sizeof(double));
+    memcpy(sorted, samples, options->samples * sizeof(double));
+    result.median   = WOBenchmarkMedian(sorted, options->samples);
+    result.minimum  = sorted[0];
+    WOBenchmarkMedianInterval(sorted, options->samples, &result.medianLow, &result.medianHigh);
+    for (unsigned i = 0; i < options->samples; i++)
+        sorted[i] = fabs(sorted[i] - result.median);
+    result.mad      = WOBenchmarkMedian(sorted, options->samples);
+    free(sorted);
+    free(processor);
+
+    // counting allocations perturbs timing, so it gets a pass of its own
+    result.allocations = result.bytesAllocated = -1.0;
+    if ([WOAllocationMeter isSupported])
+    {
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+        WOAllocationMeter *meter = [WOAllocationMeter allocationMeter];
+        WOBenchmarkAllocationMeter = meter;
+        body(fixture, iterations);
+        [meter pause];
+        WOBenchmarkAllocationMeter = nil;
+        WOAllocationCounts counts = [meter counts];
+        result.allocations      = (double)counts.allocations / iterations;
+        result.bytesAllocated   = (double)counts.bytesAllocated / iterations;
+        [pool drain];
+    }
+    return result;
+}
+
+#pragma mark -
+#pragma mark Output
+
+//! Formats \p nanoseconds with a unit chosen to keep three or four
+//! significant figures.
+static const char *WOBenchmarkFormatTime(char *buffer, size_t size, double nanoseconds)
+{
+    if (nanoseconds < 1e3)
+        snprintf(buffer, size, "%.1f ns", nanoseconds);
+    else if (nanoseconds < 1e6)
+        snprintf(buffer, size, "%.2f us", nanoseconds / 1e3);
+    else if (nanoseconds < 1e9)
+        snprintf(buffer, size, "%.2f ms", nanoseconds / 1e6);
+    else
+        snprintf(buffer, size, "%.3f s", nanoseconds / 1e9);
+    return buffer;
+}
+
+//! Formats the throughput of \p bytes per \p nanoseconds in binary units.
+static const char *WOBenchmarkFormatThroughput(char *buffer, size_t size, uint64_t bytes, double nanoseconds)
+{
+    static const char *units[] = { "B/s", "KiB/s", "MiB/s", "GiB/s" };
+    double rate = nanoseconds > 0 ? bytes * 1e9 / nanoseconds : 0;
+    unsigned unit = 0;
+    while (rate >= 1024 && unit < sizeof(units) / sizeof(units[0]) - 1)
+    {
+        rate /= 1024;
+        unit++;
+    }
+    snprintf(buffer, size, "%.1f %s", rate, units[unit]);
+    return buffer;
+}
+
+static void WOBenchmarkPrintHeader(FILE *file)
+{
+    fprintf(file, "%-50s %10s %11s %11s %8s %11s %10s %12s %13s\n",
+            "benchmark", "iterations", "min", "median", "mad", "cpu", "allocs/op", "bytes/op", "throughput");
+}
+
+static void WOBenchmarkPrintResult(FILE *file, WOBenchmarkResult *result)
+{
+    char minimum[32], median[32], processor[32];
+    fprintf(file, "%-50s %10llu %11s %11s %7.1f%% %11s ",
+            result->name, (unsigned long long)result->iterations,
+            WOBenchmarkFormatTime(minimum, sizeof(minimum), result->minimum),
+            WOBenchmarkFormatTime(median, sizeof(median), result->median),
+            result->median > 0 ? 100.0 * result->mad / result->median : 0.0,
+            WOBenchmarkFormatTime(processor, sizeof(processor), result->processorMedian));
+    if (result->allocations < 0)
+        fprintf(file, "%10s %12s ", "-", "-");
+    else
+        fprintf(file, "%10.1f %12.0f ", result->allocations, result->bytesAllocated);
+    char throughput[32];
+    fprintf(file, "%13s\n", result->bytesPerOperation == 0 ? "-" :
+            WOBenchmarkFormatThroughput(throughput, sizeof(throughput), result->bytesPerOperation, result->median));
+    fflush(file);
+}
+
+static void WOBenchmarkWriteString(FILE *file, const char *string)
+{
+    fputc('"', file);
+    for (const char *c = string; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            fprintf(file, "\\%c", *c);
+        else if ((unsigned char)*c < 0x20)
+            fprintf(file, "\\u%04x", *c);
+        else
+            fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+static void WOBenchmarkWriteJSON(FILE *file, WOBenchmarkResult *results, unsigned resultCount,
+                                 WOBenchmarkOptions *options)
+{
+    fprintf(file, "{\n  \"unit\": \"nanosecondsPerOperation\",\n  \"samples\": %u,\n"
+            "  \"sampleSeconds\": %g,\n  \"warmupSeconds\": %g,\n  \"results\": [\n",
+            options->samples, options->sampleTime, options->warmupTime);
+    for (unsigned i = 0; i < resultCount; i++)
+    {
+        WOBenchmarkResult *result = &results[i];
+        fprintf(file, "    {\"name\": ");
+        WOBenchmarkWriteString(file, result->name);
+        fprintf(file, ", \"iterations\": %llu, \"minimum\": %.3f, \"median\": %.3f, \"mad\": %.3f, "
+                "\"medianInterval\": [%.3f, %.3f], \"processorMedian\": %.3f, ",
+                (unsigned long long)result->iterations, result->minimum, result->median, result->mad,
+                result->medianLow, result->medianHigh, result->processorMedian);
+        if (result->allocations < 0)
+            fprintf(file, "\"allocations\": null, \"bytesAllocated\": null, ");
+        else
+            fprintf(file, "\"allocations\": %.3f, \"bytesAllocated\": %.3f, ", result->allocations,
+                    result->bytesAllocated);
+        if (result->bytesPerOperation)
+            fprintf(file, "\"bytesPerOperation\": %llu, \"bytesPerSecond\": %.0f, ",
+                    (unsigned long long)result->bytesPerOperation, result->bytesPerOperation * 1e9 / result->median);
+        fprintf(file, "\"samples\": [");
+        for (unsigned j = 0; j < result->sampleCount; j++)
+            fprintf(file, "%s%.3f", j ? ", " : "", result->samples[j]);
+        fprintf(file, "]}%s\n", i + 1 < resultCount ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+#pragma mark -
+#pragma mark Baseline comparison
+
+//! Loads the per-case samples of a results file written by --json, keyed by
+//! case name. Returns nil, having printed the reason, if it can't be read.
+static NSDictionary *WOBenchmarkLoadBaseline(const char *path)
+{
+    NSData *data = [NSData dataWithContentsOfFile:[NSString stringWithUTF8String:path]];
+    if (!data)
+    {
+        fprintf(stderr, "unable to read baseline %s\n", path);
+        return nil;
+    }
+    NSError *error = nil;
+    id root = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
+    NSArray *results = [root isKindOfClass:[NSDictionary class]] ? [root objectForKey:@"results"] : nil;
+    if (![results isKindOfClass:[NSArray class]])
+    {
+        fprintf(stderr, "baseline %s is not a benchmark results file%s%s\n", path, error ? ": " : "",
+                error ? [[error localizedDescription] UTF8String] : "");
+        return nil;
+    }
+    NSMutableDictionary *baseline = [NSMutableDictionary dictionary];
+    for (NSDictionary *result in results)
+    {
+        if (![result isKindOfClass:[NSDictionary class]])
+            continue;
+        NSString *name = [result objectForKey:@"name"];
+        NSArray *samples = [result objectForKey:@"samples"];
+        if ([name isKindOfClass:[NSString class]] && [samples isKindOfClass:[NSArray class]] && [samples count])
+            [baseline setObject:samples forKey:name];
+    }
+    return baseline;
+}
+
+typedef enum WOBenchmarkVerdict {
+
+    WOBenchmarkUnchanged,
+    WOBenchmarkFaster,
+    WOBenchmarkSlower,
+    WOBenchmarkRegression,
+    WOBenchmarkNew
+
+} WOBenchmarkVerdict;
+
+static const char *WOBenchmarkVerdictNames[] = { "unchanged", "faster", "slower", "REGRESSION", "new" };
+
+//! Compares \p result with the \p baseline samples of the same case. A
+//! change is significant only when the confidence intervals for the two
+//! medians do not overlap; a significant slowdown is a regression once the
+//! median has grown by more than \p threshold percent.
+static WOBenchmarkVerdict WOBenchmarkCompare(WOBenchmarkResult *result, NSArray *baseline, double threshold,
+                                             double *baselineMedian)
+{
+    if (!baseline)
+        return WOBenchmarkNew;
+    unsigned count = (unsigned)[baseline count];
+    double *sorted = malloc(count * sizeof(double));
+    for (unsigned i = 0; i < count; i++)
+        sorted[i] = [[baseline objectAtIndex:i] doubleValue];
+    double low, high;
+    *baselineMedian = WOBenchmarkMedian(sorted, count);
+    WOBenchmarkMedianInterval(sorted, count, &low, &high);
+    free(sorted);
+
+    if (result->medianLow > high)
+    {
+        double change = 100.0 * (result->median - *baselineMedian) / *baselineMedian;
+        return change > threshold ? WOBenchmarkRegression : WOBenchmarkSlower;
+    }
+    else if (result->medianHigh < low)
+        return WOBenchmarkFaster;
+    return WOBenchmarkUnchanged;
+}
+
+//! Prints the comparison of \p results against \p baseline to \p file and
+//! returns the number of regressions.
+static unsigned WOBenchmarkPrintComparison(FILE *file, WOBenchmarkResult *results, unsigned resultCount,
+                                           NSDictionary *baseline, WOBenchmarkOptions *options)
+{
+    unsigned regressions = 0;
+    fprintf(file, "\n%-50s %11s %11s %9s  %s\n", "benchmark", "baseline", "median", "change", "verdict");
+    for (unsigned i = 0; i < resultCount; i++)
+    {
+        WOBenchmarkResult *result = &results[i];
+        double baselineMedian = 0;
+        NSArray *samples = [baseline objectForKey:[NSString stringWithUTF8String:result->name]];
+        WOBenchmarkVerdict verdict = WOBenchmarkCompare(result, samples, options->threshold, &baselineMedian);
+        char before[32], after[32];
+        if (verdict == WOBenchmarkNew)
+            fprintf(file, "%-50s %11s %11s %9s  %s\n", result->name, "-",
+                    WOBenchmarkFormatTime(after, sizeof(after), result->median), "-", WOBenchmarkVerdictNames[verdict]);
+        else
+            fprintf(file, "%-50s %11s %11s %+8.1f%%  %s\n", result->name,
+                    WOBenchmarkFormatTime(before, sizeof(before), baselineMedian),
+                    WOBenchmarkFormatTime(after, sizeof(after), result->median),
+                    baselineMedian > 0 ? 100.0 * (result->median - baselineMedian) / baselineMedian : 0.0,
+                    WOBenchmarkVerdictNames[verdict]);
+        if (verdict == WOBenchmarkRegression)
+            regressions++;
+    }
+    if (regressions)
+        fprintf(file, "\n%u regression%s beyond %g%%\n", regressions, regressions == 1 ? "" : "s", options->threshold);
+    return regressions;
+}
+
+#pragma mark -
+#pragma mark Command line
+
+static void WOBenchmarkUsage(const char *name)
+{
+    fprintf(stderr, "usage: %s [--filter TEXT]... [--samples N] [--sample-time SECONDS] "
+            "[--warmup SECONDS] [--json FILE] [--baseline FILE [--threshold PERCENT]] [--list]\n", name);
+    fprintf(stderr, "  --filter TEXT          only run cases whose name contains TEXT (repeatable)\n");
+    fprintf(stderr, "  --samples N            samples per case (default %u)\n", WO_BENCHMARK_DEFAULT_SAMPLES);
+    fprintf(stderr, "  --sample-time SECONDS  minimum duration of one sample (default %g)\n",
+            WO_BENCHMARK_DEFAULT_SAMPLE_TIME);
+    fprintf(stderr, "  --warmup SECONDS       time spent running each case before sampling (default %g)\n",
+            WO_BENCHMARK_DEFAULT_WARMUP_TIME);
+    fprintf(stderr, "  --json FILE            also write results as JSON to FILE (\"-\" for standard\n"
+            "                         output, in which case the table goes to standard error)\n");
+    fprintf(stderr, "  --baseline FILE        compare with results previously written by --json, exiting with\n"
+            "                         status 2 if any case is significantly slower beyond the threshold\n");
+    fprintf(stderr, "  --threshold PERCENT    slowdown of the median tolerated by --baseline (default %g)\n",
+            WO_BENCHMARK_DEFAULT_THRESHOLD);
+    fprintf(stderr, "  --list                 print the names of the selected cases and exit\n");
+}
+
+int WOBenchmarkMain(int argc, char *argv[])
+{
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    WOBenchmarkOptions options = {
+        .samples    = WO_BENCHMARK_DEFAULT_SAMPLES,
+        .sampleTime = WO_BENCHMARK_DEFAULT_SAMPLE_TIME,
+        .warmupTime = WO_BENCHMARK_DEFAULT_WARMUP_TIME,
+        .threshold  = WO_BENCHMARK_DEFAULT_THRESHOLD
+    };
+    const char *jsonPath = NULL;
+    BOOL list = NO;
+    static struct option longOptions[] = {
+        { "filter",         required_argument,  NULL, 'f' },
+        { "samples",        required_argument,  NULL, 's' },
+        { "sample-time",    required_argument,  NULL, 't' },
+        { "warmup",         required_argument,  NULL, 'w' },
+        { "json",           required_argument,  NULL, 'j' },
+        { "baseline",       required_argument,  NULL, 'b' },
+        { "threshold",      required_argument,  NULL, 'r' },
+        { "list",           no_argument,        NULL, 'l' },
+        { "help",           no_argument,        NULL, 'h' },
+        { NULL,             0,                  NULL, 0 }
+    };
+    int option;
+    while ((option = getopt_long(argc, argv, "f:s:t:w:j:b:r:lh", longOptions, NULL)) != -1)
+    {
+        switch (option)
+        {
+            case 'f':
+                if (options.filterCount < WO_BENCHMARK_MAX_FILTERS)
+                    options.filters[options.filterCount++] = optarg;
+                break;
+            case 's': options.samples = (unsigned)strtoul(optarg, NULL, 10); break;
+            case 't': options.sampleTime = strtod(optarg, NULL); break;
+            case 'w': options.warmupTime = strtod(optarg, NULL); break;
+            case 'j': jsonPath = optarg; break;
+            case 'b': options.baselinePath = optarg; break;
+            case 'r': options.threshold = strtod(optarg, NULL); break;
+            case 'l': list = YES; break;
+            default:
+                WOBenchmarkUsage(argv[0]);
+                return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (options.samples == 0 || options.sampleTime <= 0 || options.warmupTime < 0 || options.threshold < 0)
+    {
+        WOBenchmarkUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    NSMutableArray *selected = [NSMutableArray array];
+    for (WOBenchmarkCase *benchmark in WOBenchmarkCases)
+        if (WOBenchmarkSelected(benchmark, &options))
+            [selected addObject:benchmark];
+    if (list)
+    {
+        for (WOBenchmarkCase *benchmark in selected)
+            printf("%s\n", [[benchmark name] UTF8String]);
+        return EXIT_SUCCESS;
+    }
+    if ([selected count] == 0)
+    {
+        fprintf(stderr, "%s: no benchmarks selected\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // load the baseline first so that a bad path fails before the run
+    NSDictionary *baseline = nil;
+    if (options.baselinePath && !(baseline = WOBenchmarkLoadBaseline(options.baselinePath)))
+        return EXIT_FAILURE;
+
+    // keep standard output parseable when the JSON goes there
+    FILE *report = (jsonPath && strcmp(jsonPath, "-") == 0) ? stderr : stdout;
+
+    unsigned resultCount = 0;
+    WOBenchmarkResult *results = calloc([selected count], sizeof(WOBenchmarkResult));
+    WOBenchmarkPrintHeader(report);
+    for (WOBenchmarkCase *benchmark in selected)
+    {
+        results[resultCount] = WOBenchmarkMeasure(benchmark, &options);
+        WOBenchmarkPrintResult(report, &results[resultCount++]);
+    }
+
+    int status = EXIT_SUCCESS;
+    if (jsonPath)
+    {
+        FILE *file = strcmp(jsonPath, "-") == 0 ? stdout : fopen(jsonPath, "w");
+        if (file)
+        {
+            WOBenchmarkWriteJSON(file, results, resultCount, &options);
+            if (file != stdout)
+                fclose(file);
+        }
+        else
+        {
+            perror("fopen");
+            status = EXIT_FAILURE;
+        }
+    }
+    if (baseline && WOBenchmarkPrintComparison(report, results, resultCount, baseline, &options) > 0 &&
+        status == EXIT_SUCCESS)
+        status = WO_BENCHMARK_REGRESSION_STATUS;
+    for (unsigned i = 0; i < resultCount; i++)
+    {
+        free((char *)results[i].name);
+        free(results[i].samples);
+    }
+    free(results);
+    [pool drain];
+    return status;
+}
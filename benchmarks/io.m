@@ -0,0 +1,346 @@
+// io.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// system headers
+#import <Foundation/Foundation.h>
+#import <fcntl.h>               /* open(), posix_fadvise() */
+#import <sys/mman.h>            /* mmap(), msync() */
+#import <unistd.h>              /* read(), write(), ftruncate() */
+
+// macro headers
+#import "WOConvenienceMacros.h"
+
+// other headers
+#import "WOBenchmark.h"
+
+// class headers
+#import "WOMappedData.h"
+
+// category headers
+#import "NSString+WOFileUtilities.h"
+
+#define WO_IO_CHUNK_SIZE    (1024 * 1024)
+#define WO_IO_PAGE_SIZE     4096
+
+//! A process can only discard a file's cached pages through these; where
+//! neither exists only the warm cases are registered.
+#if defined(__APPLE__) || defined(POSIX_FADV_DONTNEED)
+#define WO_IO_CAN_EVICT 1
+#endif
+
+typedef struct WOIOSize {
+
+    const char  *label;
+    uint64_t    bytes;
+
+} WOIOSize;
+
+static const WOIOSize WOIOSizes[] = {
+    { "4K",     4ULL << 10 },
+    { "64K",    64ULL << 10 },
+    { "1M",     1ULL << 20 },
+    { "16M",    16ULL << 20 },
+    { "256M",   256ULL << 20 },
+    { "1G",     1ULL << 30 },
+    { "4G",     4ULL << 30 }
+};
+
+//! Largest size read in one call by WOMappedData or written in one call by
+//! -[NSString appendToFile:]: Darwin's read() and write() reject counts above
+//! INT_MAX, so neither API handles the larger files.
+#define WO_IO_MAX_SINGLE_CALL_SIZE (1ULL << 30)
+
+//! Largest size registered by default, so that a plain run (and every
+//! --baseline gating run) stays quick and needs little disk space.
+#define WO_IO_DEFAULT_MAX_SIZE (64ULL << 20)
+
+//! Setting this environment variable (to anything) also registers the sizes
+//! above WO_IO_DEFAULT_MAX_SIZE, which need several gigabytes of disk space
+//! and take minutes to run. It has to be an environment variable because
+//! cases are registered before the command line is parsed.
+#define WO_IO_LARGE_FILES_ENVIRONMENT "WO_BENCHMARK_LARGE_FILES"
+
+#pragma mark -
+#pragma mark Files
+
+static NSString *WOIODirectory      = nil;
+
+//! Only the most recently created input file is kept, so that the suite
+//! needs disk space for its largest file rather than for all of them.
+static NSString *WOIOInputPath      = nil;
+static uint64_t WOIOInputSize       = 0;
+
+static NSString *WOIODirectoryPath(void)
+{
+    if (!WOIODirectory)
+    {
+        char directoryTemplate[PATH_MAX];
+        snprintf(directoryTemplate, sizeof(directoryTemplate), "%s/WOIOBenchmarks.XXXXXX",
+                 [NSTemporaryDirectory() fileSystemRepresentation]);
+        if (!mkdtemp(directoryTemplate))
+        {
+            perror("mkdtemp");
+            exit(EXIT_FAILURE);
+        }
+        WOIODirectory = [[NSString alloc] initWithUTF8String:directoryTemplate];
+    }
+    return WOIODirectory;
+}
+
+// returns the path of a file of size bytes, creating it if necessary
+static NSString *WOIOInputFile(uint64_t size)
+{
+    if (WOIOInputPath && WOIOInputSize == size)
+        return WOIOInputPath;
+    if (WOIOInputPath)
+        unlink([WOIOInputPath fileSystemRepresentation]);
+
+    NSString *path = [WOIODirectoryPath() stringByAppendingPathComponent:WO_STRING(@"input-%llu",
+                                                                                   (unsigned long long)size)];
+    int descriptor = open([path fileSystemRepresentation], O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    if (descriptor < 0)
+    {
+        perror("open");
+        exit(EXIT_FAILURE);
+    }
+    char *chunk = malloc(WO_IO_CHUNK_SIZE);
+    memset(chunk, 'x', WO_IO_CHUNK_SIZE);
+    for (uint64_t written = 0; written < size; )
+    {
+        ssize_t count = write(descriptor, chunk, (size_t)MIN(size - written, WO_IO_CHUNK_SIZE));
+        if (count <= 0)
+        {
+            perror("write");
+            exit(EXIT_FAILURE);
+        }
+        written += count;
+    }
+    free(chunk);
+    close(descriptor);
+    WOIOInputPath = [path copy];
+    WOIOInputSize = size;
+    return WOIOInputPath;
+}
+
+#ifdef WO_IO_CAN_EVICT
+
+// discards the cached pages of the file at path so the next read goes to disk
+static void WOIOEvict(NSString *path, uint64_t size)
+{
+    int descriptor = open([path fileSystemRepresentation], O_RDONLY);
+    if (descriptor < 0)
+        return;
+#ifdef __APPLE__
+    // there is no fadvise(); invalidating a shared mapping of the whole file
+    // drops its clean pages from the unified buffer cache instead
+    void *mapping = mmap(NULL, (size_t)size, PROT_READ, MAP_SHARED, descriptor, 0);
+    if (mapping != MAP_FAILED)
+    {
+        msync(mapping, (size_t)size, MS_INVALIDATE);
+        munmap(mapping, (size_t)size);
+    }
+#else
+    posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    close(descriptor);
+}
+
+#endif /* WO_IO_CAN_EVICT */
+
+WO_UNLOAD removeIOBenchmarkFiles(void)
+{
+    if (WOIODirectory)
+        [[NSFileManager defaultManager] removeItemAtPath:WOIODirectory error:NULL];
+}
+
+#pragma mark -
+#pragma mark Readers
+
+//! Visits one byte per page, so lazily mapped data is actually read and
+//! eagerly read data is compared on an equal footing.
+static unsigned char WOIOTouch(const unsigned char *bytes, uint64_t length)
+{
+    unsigned char sum = 0;
+    for (uint64_t i = 0; i < length; i += WO_IO_PAGE_SIZE)
+        sum += bytes[i];
+    return sum;
+}
+
+//! Sink for touched bytes, so the compiler cannot drop the reads.
+static volatile unsigned char WOIOSink;
+
+typedef enum WOIOReader {
+
+    WOIOReaderRead,
+    WOIOReaderMappedNSData,
+    WOIOReaderMappedData,
+    WOIOReaderCount
+
+} WOIOReader;
+
+static const char *WOIOReaderNames[WOIOReaderCount] = {
+    "read()", "-[NSData dataWithContentsOfFile:options:] mapped", "-[WOMappedData initWithContentsOfFile:]"
+};
+
+// reads the file at path with reader, returning once the whole file (or, if
+// firstByte is YES, just its first byte) is in memory
+static void WOIOReadFile(WOIOReader reader, NSString *path, BOOL firstByte)
+{
+    switch (reader)
+    {
+        case WOIOReaderRead:
+        {
+            // chunked, as any reader of files larger than memory must be
+            static char buffer[WO_IO_CHUNK_SIZE];
+            int descriptor = open([path fileSystemRepresentation], O_RDONLY);
+            ssize_t count;
+            while ((count = read(descriptor, buffer, firstByte ? WO_IO_PAGE_SIZE : sizeof(buffer))) > 0)
+            {
+                WOIOSink = buffer[0];
+                if (firstByte)
+                    break;
+            }
+            close(descriptor);
+            break;
+        }
+        case WOIOReaderMappedNSData:
+        {
+            NSData *data = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedAlways error:NULL];
+            WOIOSink = WOIOTouch([data bytes], firstByte ? MIN([data length], 1) : [data length]);
+            break;
+        }
+        case WOIOReaderMappedData:
+        {
+            WOMappedData *data = [[WOMappedData alloc] initWithContentsOfFile:path];
+            WOIOSink = WOIOTouch([data bytes], firstByte ? MIN([data size], 1) : [data size]);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void registerReadBenchmark(WOIOReader reader, WOIOSize size, BOOL firstByte, BOOL cold)
+{
+    NSString *name = WO_STRING(@"io/%s/%s/%s/%s", size.label, WOIOReaderNames[reader],
+                               firstByte ? "first-byte" : "whole", cold ? "cold" : "warm");
+    uint64_t bytes = size.bytes;
+    WOBenchmarkRegisterWithBytes([name UTF8String], firstByte ? 0 : bytes, ^{
+        return (id)WOIOInputFile(bytes);
+    }, ^(id path, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+#ifdef WO_IO_CAN_EVICT
+            if (cold)
+            {
+                WOBenchmarkPauseTiming();
+                WOIOEvict(path, bytes);
+                WOBenchmarkResumeTiming();
+            }
+#endif
+            WOIOReadFile(reader, path, firstByte);
+        }
+    });
+}
+
+#pragma mark -
+#pragma mark Writers
+
+typedef enum WOIOWriter {
+
+    WOIOWriterWrite,
+    WOIOWriterAppendToFile,
+    WOIOWriterCount
+
+} WOIOWriter;
+
+static const char *WOIOWriterNames[WOIOWriterCount] = { "write()", "-[NSString appendToFile:]" };
+
+// each operation appends size bytes to an empty file; truncation between
+// operations is not timed
+static void registerWriteBenchmark(WOIOWriter writer, WOIOSize size)
+{
+    NSString *name = WO_STRING(@"io/%s/%s/append", size.label, WOIOWriterNames[writer]);
+    uint64_t bytes = size.bytes;
+    WOBenchmarkRegisterWithBytes([name UTF8String], bytes, ^{
+        char *characters = malloc((size_t)bytes);
+        memset(characters, 'x', (size_t)bytes);
+        return (id)[[NSString alloc] initWithBytesNoCopy:characters length:(NSUInteger)bytes
+                                                encoding:NSASCIIStringEncoding freeWhenDone:YES];
+    }, ^(id string, uint64_t iterations) {
+        NSString *path = [WOIODirectoryPath() stringByAppendingPathComponent:@"output"];
+        const char *characters = [string UTF8String];
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            WOBenchmarkPauseTiming();
+            truncate([path fileSystemRepresentation], 0);
+            WOBenchmarkResumeTiming();
+            if (writer == WOIOWriterAppendToFile)
+                (void)[string appendToFile:path];
+            else
+            {
+                // the same open, lock and single write, minus the conversion
+                int descriptor = open([path fileSystemRepresentation], O_CREAT | O_WRONLY | O_APPEND | O_EXLOCK,
+                                      0644);
+                (void)write(descriptor, characters, (size_t)bytes);
+                close(descriptor);
+            }
+        }
+        unlink([path fileSystemRepresentation]);
+    });
+}
+
+#pragma mark -
+#pragma mark Registration
+
+// cases are ordered by size so that each input file is created only once
+WO_LOAD registerIOBenchmarks(void)
+{
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    BOOL largeFiles = getenv(WO_IO_LARGE_FILES_ENVIRONMENT) != NULL;
+    for (size_t i = 0; i < sizeof(WOIOSizes) / sizeof(WOIOSizes[0]); i++)
+    {
+        WOIOSize size = WOIOSizes[i];
+        if (size.bytes > WO_IO_DEFAULT_MAX_SIZE && !largeFiles)
+            continue;
+        for (WOIOReader reader = 0; reader < WOIOReaderCount; reader++)
+        {
+            if (reader == WOIOReaderMappedData && size.bytes > WO_IO_MAX_SINGLE_CALL_SIZE)
+                continue;
+            for (int firstByte = 0; firstByte <= 1; firstByte++)
+            {
+                registerReadBenchmark(reader, size, firstByte, NO);
+#ifdef WO_IO_CAN_EVICT
+                registerReadBenchmark(reader, size, firstByte, YES);
+#endif
+            }
+        }
+        for (WOIOWriter writer = 0; writer < WOIOWriterCount; writer++)
+            if (size.bytes <= WO_IO_MAX_SINGLE_CALL_SIZE)
+                registerWriteBenchmark(writer, size);
+    }
+    [pool drain];
+}
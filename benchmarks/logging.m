@@ -0,0 +1,395 @@
+// logging.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// system headers
+#import <Foundation/Foundation.h>
+#import <asl.h>                 /* ASL_LEVEL_NOTICE */
+#import <fcntl.h>               /* open() */
+#import <getopt.h>              /* getopt_long() */
+#import <pthread.h>
+#import <spawn.h>               /* posix_spawn() */
+#import <sys/time.h>
+#import <sys/wait.h>            /* waitpid() */
+#import <unistd.h>              /* dup(), dup2() */
+
+// macro headers
+#import "WOConvenienceMacros.h"
+
+// class headers
+#import "WOHistogram.h"
+#import "WOLogFileSink.h"
+#import "WOLogManager.h"
+#import "WOLogRingBuffer.h"
+#import "WOUsageMeter.h"
+
+#define WO_ONE_MILLION 1000000
+
+#define WO_LOG_DEFAULT_MESSAGES_PER_THREAD 10000
+#define WO_LOG_MAX_THREADS 64
+#define WO_LOG_MAX_PROCESSES 16
+#define WO_LOG_MAX_RESULTS 256
+
+//! Argument which makes the benchmark run as a writer process for
+//! processThroughput(); followed by "shared" or "locked", the log path and the
+//! message count.
+#define WO_LOG_WRITER_ARGUMENT "--log-writer"
+
+extern char **environ;
+
+//! The public logging paths exercised by the benchmark.
+typedef enum WOLogPath {
+
+    WOLogPathStandardError,
+    WOLogPathFile,
+    WOLogPathSharedFile,
+    WOLogPathAsynchronous,
+    WOLogPathSink,
+    WOLogPathCount
+
+} WOLogPath;
+
+static const char *WOLogPathNames[WOLogPathCount] = { "stderr", "file", "shared-file", "async", "sink" };
+
+//! Message payload sizes in bytes. The largest leaves room for the record
+//! header within WO_LOG_RECORD_CAPACITY, so that asynchronous records are
+//! never truncated and bytes/s reflects the bytes actually written.
+static const size_t WOLogMessageSizes[] = { 16, 128, 768 };
+
+typedef struct WOLogThreadContext {
+
+    pthread_t   thread;
+    WOLogPath   path;
+    const char  *message;
+    unsigned    count;
+
+    //! Caller-side latency of each message; shared by all threads.
+    WOHistogram *latencies;
+
+} WOLogThreadContext;
+
+typedef struct WOLogResult {
+
+    const char  *path;
+    unsigned    threads;
+    size_t      messageSize;
+    uint64_t    messages;
+
+    //! Messages dropped by the ring buffer or the sink (asynchronous paths
+    //! only); not included in \c messages.
+    uint64_t    dropped;
+    double      seconds;
+    uint64_t    p50;
+    uint64_t    p90;
+    uint64_t    p99;
+    uint64_t    p999;
+    uint64_t    max;
+
+} WOLogResult;
+
+static double now(void)
+{
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return time.tv_sec + time.tv_usec / (double)WO_ONE_MILLION;
+}
+
+void *logFromThread(void *argument)
+{
+    WOLogThreadContext *context = argument;
+    for (unsigned i = 0; i < context->count; i++)
+    {
+        WONanoseconds start = WOMonotonicNanoseconds();
+        if (context->path == WOLogPathStandardError)
+            [WOLog logLevel:ASL_LEVEL_NOTICE message:@"%s", context->message];
+        else
+            [WOLog logToFileLevel:ASL_LEVEL_NOTICE message:@"%s", context->message];
+        WOHistogramRecord(context->latencies, WOMonotonicNanoseconds() - start);
+    }
+    return NULL;
+}
+
+// runs threadCount threads logging count messages each through path and
+// returns throughput and caller-side latency percentiles
+WOLogResult logThroughput(WOLogPath path, unsigned threadCount, size_t messageSize, unsigned count)
+{
+    char *message = malloc(messageSize + 1);
+    memset(message, 'x', messageSize);
+    message[messageSize] = '\0';
+
+    [WOLog setLogsToFileByDefault:(path != WOLogPathStandardError)];
+    [WOLog setLogsToSharedFile:(path == WOLogPathSharedFile)];
+    [WOLog setLogsAsynchronously:(path == WOLogPathAsynchronous)];
+    WOLogFileSink *sink = nil;
+    if (path == WOLogPathSink)
+    {
+        sink = [[WOLogFileSink alloc] initWithPath:[WOLog logFilePath]];
+        [WOLog addSink:sink];
+    }
+    int64_t droppedBefore = [WOLog droppedRecordCount];
+
+    WOLogThreadContext contexts[WO_LOG_MAX_THREADS];
+    WOHistogram *latencies = [WOHistogram histogram];
+    double begin = now();
+    for (unsigned i = 0; i < threadCount; i++)
+    {
+        contexts[i].path        = path;
+        contexts[i].message     = message;
+        contexts[i].count       = count;
+        contexts[i].latencies   = latencies;
+        pthread_create(&contexts[i].thread, NULL, logFromThread, &contexts[i]);
+    }
+    for (unsigned i = 0; i < threadCount; i++)
+        pthread_join(contexts[i].thread, NULL);
+    [WOLog flush];
+    [sink flush];
+    double seconds = now() - begin;
+
+    // records which never reached the file must not count towards throughput
+    int64_t dropped = [WOLog droppedRecordCount] - droppedBefore;
+    if (sink)
+    {
+        dropped += [sink droppedRecordCount];
+        [WOLog removeSink:sink];
+    }
+
+    WOHistogramSummary summary = [latencies summary];
+    WOLogResult result = {
+        .path           = WOLogPathNames[path],
+        .threads        = threadCount,
+        .messageSize    = messageSize,
+        .messages       = summary.count - (uint64_t)dropped,
+        .dropped        = (uint64_t)dropped,
+        .seconds        = seconds,
+        .p50            = summary.p50,
+        .p90            = summary.p90,
+        .p99            = summary.p99,
+        .p999           = summary.p999,
+        .max            = summary.maximum
+    };
+    free(message);
+    return result;
+}
+
+// body of a writer process spawned by processThroughput()
+int logWriter(const char *mode, const char *path, unsigned count)
+{
+    [WOLog setLogFilePath:[NSString stringWithUTF8String:path]];
+    [WOLog setLogsToSharedFile:(strcmp(mode, "shared") == 0)];
+    for (unsigned i = 0; i < count; i++)
+        [WOLog logToFileMessage:@"benchmark message %u", i];
+    return EXIT_SUCCESS;
+}
+
+// returns messages per second (wall-clock) for processCount processes logging
+// concurrently to the same file
+double processThroughput(const char *executable, unsigned processCount, BOOL shared, NSString *path, unsigned count)
+{
+    pid_t processes[WO_LOG_MAX_PROCESSES];
+    char countString[16];
+    snprintf(countString, sizeof(countString), "%u", count);
+    char *arguments[] = {
+        (char *)executable, WO_LOG_WRITER_ARGUMENT, shared ? "shared" : "locked",
+        (char *)[path fileSystemRepresentation], countString, NULL
+    };
+    double begin = now();
+    for (unsigned i = 0; i < processCount; i++)
+    {
+        if (posix_spawn(&processes[i], executable, NULL, NULL, arguments, environ) != 0)
+        {
+            perror("posix_spawn");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (unsigned i = 0; i < processCount; i++)
+        waitpid(processes[i], NULL, 0);
+    return (processCount * count) / (now() - begin);
+}
+
+void writeJSON(FILE *file, WOLogResult *results, unsigned resultCount, double *locked, double *shared,
+               unsigned processSteps, unsigned count)
+{
+    fprintf(file, "{\n  \"benchmark\": \"WOLogManager\",\n  \"messagesPerThread\": %u,\n  \"results\": [\n", count);
+    for (unsigned i = 0; i < resultCount; i++)
+    {
+        WOLogResult *result = &results[i];
+        fprintf(file, "    {\"path\": \"%s\", \"threads\": %u, \"messageSize\": %lu, \"messages\": %llu, "
+                "\"dropped\": %llu, \"seconds\": %.6f, \"messagesPerSecond\": %.0f, \"bytesPerSecond\": %.0f, "
+                "\"latencyNanoseconds\": {\"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"p999\": %llu, \"max\": %llu}}%s\n",
+                result->path, result->threads, (unsigned long)result->messageSize,
+                (unsigned long long)result->messages, (unsigned long long)result->dropped, result->seconds,
+                result->messages / result->seconds,
+                result->messages * result->messageSize / result->seconds,
+                (unsigned long long)result->p50, (unsigned long long)result->p90, (unsigned long long)result->p99,
+                (unsigned long long)result->p999, (unsigned long long)result->max,
+                i + 1 < resultCount ? "," : "");
+    }
+    fprintf(file, "  ],\n  \"multiProcess\": [\n");
+    for (unsigned i = 0; i < processSteps; i++)
+        fprintf(file, "    {\"processes\": %u, \"lockedMessagesPerSecond\": %.0f, \"sharedMessagesPerSecond\": %.0f}%s\n",
+                1U << i, locked[i], shared[i], i + 1 < processSteps ? "," : "");
+    fprintf(file, "  ]\n}\n");
+}
+
+void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [--messages N] [--max-threads N] [--path NAME] [--json FILE]\n", name);
+    fprintf(stderr, "  --messages N     messages logged per thread (default %u)\n", WO_LOG_DEFAULT_MESSAGES_PER_THREAD);
+    fprintf(stderr, "  --max-threads N  highest thread count, up to %u (default %u)\n", WO_LOG_MAX_THREADS,
+            WO_LOG_MAX_THREADS);
+    fprintf(stderr, "  --path NAME      only benchmark stderr, file, shared-file, async or sink\n");
+    fprintf(stderr, "  --json FILE      also write results as JSON to FILE (\"-\" for standard output)\n");
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 5 && strcmp(argv[1], WO_LOG_WRITER_ARGUMENT) == 0)
+        return logWriter(argv[2], argv[3], (unsigned)strtoul(argv[4], NULL, 10));
+
+    unsigned count          = WO_LOG_DEFAULT_MESSAGES_PER_THREAD;
+    unsigned maxThreads     = WO_LOG_MAX_THREADS;
+    const char *onlyPath    = NULL;
+    const char *jsonPath    = NULL;
+    static struct option options[] = {
+        { "messages",       required_argument,  NULL, 'm' },
+        { "max-threads",    required_argument,  NULL, 't' },
+        { "path",           required_argument,  NULL, 'p' },
+        { "json",           required_argument,  NULL, 'j' },
+        { "help",           no_argument,        NULL, 'h' },
+        { NULL,             0,                  NULL, 0 }
+    };
+    int option;
+    while ((option = getopt_long(argc, argv, "m:t:p:j:h", options, NULL)) != -1)
+    {
+        switch (option)
+        {
+            case 'm': count = (unsigned)strtoul(optarg, NULL, 10); break;
+            case 't': maxThreads = MIN((unsigned)strtoul(optarg, NULL, 10), WO_LOG_MAX_THREADS); break;
+            case 'p': onlyPath = optarg; break;
+            case 'j': jsonPath = optarg; break;
+            default:
+                usage(argv[0]);
+                return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (count == 0 || maxThreads == 0)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // everything is written beneath a private temporary directory
+    char directoryTemplate[PATH_MAX];
+    snprintf(directoryTemplate, sizeof(directoryTemplate), "%s/WOLogBenchmarks.XXXXXX",
+             [NSTemporaryDirectory() fileSystemRepresentation]);
+    if (!mkdtemp(directoryTemplate))
+    {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+    NSString *directory = [NSString stringWithUTF8String:directoryTemplate];
+    NSString *logPath = [directory stringByAppendingPathComponent:@"benchmark.log"];
+    NSString *errorPath = [directory stringByAppendingPathComponent:@"stderr.log"];
+    [WOLog setLogFilePath:logPath];
+
+    // keep standard output parseable when the JSON goes there
+    FILE *report = (jsonPath && strcmp(jsonPath, "-") == 0) ? stderr : stdout;
+
+    static WOLogResult results[WO_LOG_MAX_RESULTS];
+    unsigned resultCount = 0;
+    fprintf(report, "%-12s %7s %6s %14s %14s %9s %10s %10s %10s %10s %10s\n",
+            "path", "threads", "size", "messages/s", "bytes/s", "dropped", "p50 ns", "p90 ns", "p99 ns", "p999 ns", "max ns");
+    for (WOLogPath path = 0; path < WOLogPathCount; path++)
+    {
+        if (onlyPath && strcmp(onlyPath, WOLogPathNames[path]) != 0)
+            continue;
+        for (size_t i = 0; i < sizeof(WOLogMessageSizes) / sizeof(WOLogMessageSizes[0]); i++)
+        {
+            for (unsigned threads = 1; threads <= maxThreads && resultCount < WO_LOG_MAX_RESULTS; threads *= 2)
+            {
+                // keep the terminal clear while benchmarking standard error
+                int savedError = -1;
+                if (path == WOLogPathStandardError)
+                {
+                    fflush(stderr);
+                    savedError = dup(STDERR_FILENO);
+                    int errorFile = open([errorPath fileSystemRepresentation], O_CREAT | O_WRONLY | O_TRUNC, 0644);
+                    dup2(errorFile, STDERR_FILENO);
+                    close(errorFile);
+                }
+                WOLogResult result = logThroughput(path, threads, WOLogMessageSizes[i], count);
+                if (savedError >= 0)
+                {
+                    fflush(stderr);
+                    dup2(savedError, STDERR_FILENO);
+                    close(savedError);
+                }
+                [[NSFileManager defaultManager] removeItemAtPath:logPath error:NULL];
+
+                results[resultCount++] = result;
+                fprintf(report, "%-12s %7u %6lu %14.0f %14.0f %9llu %10llu %10llu %10llu %10llu %10llu\n",
+                        result.path, result.threads, (unsigned long)result.messageSize,
+                        result.messages / result.seconds, result.messages * result.messageSize / result.seconds,
+                        (unsigned long long)result.dropped,
+                        (unsigned long long)result.p50, (unsigned long long)result.p90, (unsigned long long)result.p99,
+                        (unsigned long long)result.p999, (unsigned long long)result.max);
+                fflush(report);
+            }
+        }
+    }
+    [WOLog setLogsAsynchronously:NO];
+    [WOLog setLogsToSharedFile:NO];
+
+    // several processes appending to one file: exclusive lock vs O_APPEND
+    double locked[WO_LOG_MAX_PROCESSES], shared[WO_LOG_MAX_PROCESSES];
+    unsigned processSteps = 0;
+    if (!onlyPath || strcmp(onlyPath, "shared-file") == 0)
+    {
+        fprintf(report, "\n%-12s %14s %14s\n", "processes", "locked msg/s", "shared msg/s");
+        for (unsigned processCount = 1; processCount <= WO_LOG_MAX_PROCESSES; processCount *= 2, processSteps++)
+        {
+            locked[processSteps] = processThroughput(argv[0], processCount, NO, logPath, count);
+            [[NSFileManager defaultManager] removeItemAtPath:logPath error:NULL];
+            shared[processSteps] = processThroughput(argv[0], processCount, YES, logPath, count);
+            [[NSFileManager defaultManager] removeItemAtPath:logPath error:NULL];
+            fprintf(report, "%-12u %14.0f %14.0f\n", processCount, locked[processSteps], shared[processSteps]);
+        }
+    }
+
+    if (jsonPath)
+    {
+        FILE *file = strcmp(jsonPath, "-") == 0 ? stdout : fopen(jsonPath, "w");
+        if (!file)
+        {
+            perror("fopen");
+            return EXIT_FAILURE;
+        }
+        writeJSON(file, results, resultCount, locked, shared, processSteps, count);
+        if (file != stdout)
+            fclose(file);
+    }
+    [[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+    return EXIT_SUCCESS;
+}
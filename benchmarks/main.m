@@ -30,110 +30,334 @@
 // macro headers
 #import "WOConvenienceMacros.h"
 
-// class headers
-#import "WOUsageMeter.h"
+// other headers
+#import "WOBenchmark.h"
+#import "WOLazyEnumerator.h"
 
 // category headers
 #import "NSArray+WORubyBlocks.h"
 
-static WOUsageMeter *meter = nil;
+#define WO_ONE_MILLION 1000000
+#define WO_ONE_THOUSAND 1000
+
+#pragma mark -
+#pragma mark NSArray (WORubyBlocks) benchmarks
 
-void group(const char *description)
+// registers the map:, manual enumeration and fast enumeration cases over an
+// array of count strings
+static void registerMapBenchmarks(NSUInteger count)
 {
-    printf("%s\n", description);
+    WOBenchmarkSetUp setUp = ^{
+        NSMutableArray *array = [NSMutableArray arrayWithCapacity:count];
+        for (NSUInteger i = 0; i < count; i++)
+            [array addObject:WO_STRING(@"object %lu", (unsigned long)i)];
+        return (id)array;
+    };
+
+    WOBenchmarkRegister([WO_STRING(@"map/%lu/-[NSArray map:]", (unsigned long)count) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            (void)[array map:^(id string) {
+                return (id)[string stringByAppendingString:@"!"];
+            }];
+        }
+    });
+
+    WOBenchmarkRegister([WO_STRING(@"map/%lu/-[NSArray parallelMap:]", (unsigned long)count) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            (void)[array parallelMap:^(id string) {
+                return (id)[string stringByAppendingString:@"!"];
+            }];
+        }
+    });
+
+    WOBenchmarkRegister([WO_STRING(@"map/%lu/manual enumeration", (unsigned long)count) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            NSMutableArray *result = [NSMutableArray arrayWithCapacity:[array count]];
+            for (NSUInteger j = 0, max = [array count]; j < max; j++)
+            {
+                NSString *string = [array objectAtIndex:j];
+                [result addObject:[string stringByAppendingString:@"!"]];
+            }
+            (void)[result copy];
+        }
+    });
+
+    WOBenchmarkRegister([WO_STRING(@"map/%lu/fast enumeration", (unsigned long)count) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            NSMutableArray *result = [NSMutableArray arrayWithCapacity:[array count]];
+            for (NSString *string in array)
+                [result addObject:[string stringByAppendingString:@"!"]];
+            (void)[result copy];
+        }
+    });
 }
 
-void start(const char *description)
+// stands in for the expensive blocks parallelMap: is meant for: rounds of
+// FNV-1a over the string's bytes
+static id hashString(NSString *string)
 {
-    NSString *labelPadding = @"                              "; // 30 spaces
-    int paddingWidth = 30 - strlen(description);
-    if (paddingWidth > 0)
-        printf("%s", [[labelPadding substringToIndex:paddingWidth] UTF8String]);
-    printf("%s: ", description);
-    meter = [WOUsageMeter usageMeter];
+    const char *bytes = [string UTF8String];
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned round = 0; round < 256; round++)
+    {
+        for (const char *c = bytes; *c; c++)
+            hash = (hash ^ (unsigned char)*c) * 1099511628211ULL;
+    }
+    return [NSNumber numberWithUnsignedLongLong:hash];
 }
 
-void stop(void)
+// registers serial and parallel maps with an expensive block over count
+// strings, at several grain sizes
+static void registerExpensiveMapBenchmarks(NSUInteger count)
 {
-    [meter pause];
-    const char *usage = [[meter usageString] UTF8String];
-    printf("%s\n", usage);
-}
+    WOBenchmarkSetUp setUp = ^{
+        NSMutableArray *array = [NSMutableArray arrayWithCapacity:count];
+        for (NSUInteger i = 0; i < count; i++)
+            [array addObject:WO_STRING(@"object %lu", (unsigned long)i)];
+        return (id)array;
+    };
 
-#define WO_ONE_MILLION 1000000
-#define WO_ONE_THOUSAND 1000
+    WOBenchmarkRegister([WO_STRING(@"hash/%lu/-[NSArray map:]", (unsigned long)count) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+            (void)[array map:^(id string) { return hashString(string); }];
+    });
 
-int main(int argc, char *argv[])
-{
-#pragma mark -
-#pragma mark NSArray (WORubyBlocks) benchmarks
+    WOBenchmarkRegister([WO_STRING(@"hash/%lu/-[NSArray parallelMap:]", (unsigned long)count) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+            (void)[array parallelMap:^(id string) { return hashString(string); }];
+    });
 
-#pragma mark 1,000,000-element array, 1 iteration
-    group("1,000,000-element array, 1 iteration");
-    NSMutableArray *array = [NSMutableArray arrayWithCapacity:WO_ONE_MILLION];
-    for (unsigned i = 0, max = WO_ONE_MILLION; i < max; i++)
-        [array addObject:WO_STRING(@"object %d", i)];
-
-    start("-[NSArray map:]");
-    [array map:^(id string) {
-        return (id)[string stringByAppendingString:@"!"];
-    }];
-    stop();
-
-    start("manual enumeration");
-    NSMutableArray *result = [NSMutableArray arrayWithCapacity:[array count]];
-    for (unsigned i = 0, max = WO_ONE_MILLION; i < max; i++)
-    {
-        NSString *string = [array objectAtIndex:i];
-        [result addObject:[string stringByAppendingString:@"!"]];
-    }
-    (void)[result copy];
-    stop();
-
-    start("fast enumeration");
-    result = [NSMutableArray arrayWithCapacity:[array count]];
-    for (NSString *string in array)
-        [result addObject:[string stringByAppendingString:@"!"]];
-    (void)[result copy];
-    stop();
-
-#pragma mark 1000-element array, 1000 iterations
-    group("1000-element array, 1000 iterations");
-    array = [NSMutableArray arrayWithCapacity:WO_ONE_THOUSAND];
-    for (unsigned i = 0, max = WO_ONE_THOUSAND; i < max; i++)
-        [array addObject:WO_STRING(@"object %d", i)];
-
-    start("-[NSArray map:]");
-    for (unsigned i = 0, max = WO_ONE_THOUSAND; i < max; i++)
+    for (NSUInteger grainSize = 1; grainSize <= count; grainSize *= 16)
     {
-        (void)[array map:^(id string) {
-            return (id)[string stringByAppendingString:@"!"];
-        }];
+        NSString *name = WO_STRING(@"hash/%lu/-[NSArray parallelMap:grainSize:] %lu", (unsigned long)count,
+                                   (unsigned long)grainSize);
+        WOBenchmarkRegister([name UTF8String], setUp, ^(id array, uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++)
+            {
+                (void)[array parallelMap:^(id string, BOOL *stop) {
+                    return hashString(string);
+                } grainSize:grainSize];
+            }
+        });
     }
-    stop();
+}
 
-    start("manual enumeration");
-    for (unsigned i = 0, max = WO_ONE_THOUSAND; i < max; i++)
-    {
-        NSMutableArray *result = [NSMutableArray arrayWithCapacity:[array count]];
-        for (unsigned i = 0, max = WO_ONE_THOUSAND; i < max; i++)
+// eager select and reject, as callers write them without WOLazyEnumerator
+static NSArray *selectNumbers(NSArray *numbers, BOOL keep, BOOL (^block)(id))
+{
+    NSMutableArray *result = [NSMutableArray array];
+    for (id number in numbers)
+        if (block(number) == keep)
+            [result addObject:number];
+    return result;
+}
+
+// registers a select/map/reject/map chain over count numbers, built eagerly
+// with an intermediate array per stage and lazily in a single pass, in full
+// and cut short by a take
+static void registerChainBenchmarks(NSUInteger count)
+{
+    WOBenchmarkSetUp setUp = ^{
+        NSMutableArray *array = [NSMutableArray arrayWithCapacity:count];
+        for (NSUInteger i = 0; i < count; i++)
+            [array addObject:[NSNumber numberWithUnsignedInteger:i]];
+        return (id)array;
+    };
+    BOOL (^notMultipleOfThree)(id) = ^(id n) { return (BOOL)([n unsignedIntegerValue] % 3 != 0); };
+    id (^twice)(id) = ^(id n) { return (id)[NSNumber numberWithUnsignedInteger:[n unsignedIntegerValue] * 2]; };
+    BOOL (^multipleOfFive)(id) = ^(id n) { return (BOOL)([n unsignedIntegerValue] % 5 == 0); };
+    id (^successor)(id) = ^(id n) { return (id)[NSNumber numberWithUnsignedInteger:[n unsignedIntegerValue] + 1]; };
+
+    WOBenchmarkRegister([WO_STRING(@"chain/%lu/eager", (unsigned long)count) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
         {
-            NSString *string = [array objectAtIndex:i];
-            [result addObject:[string stringByAppendingString:@"!"]];
+            NSArray *selected = selectNumbers(array, YES, notMultipleOfThree);
+            NSArray *doubled = [selected map:twice];
+            NSArray *rejected = selectNumbers(doubled, NO, multipleOfFive);
+            (void)[rejected map:successor];
         }
-        (void)[result copy];
-    }
-    stop();
+    });
 
-    start("fast enumeration");
-    for (unsigned i = 0, max = WO_ONE_THOUSAND; i < max; i++)
-    {
-        result = [NSMutableArray arrayWithCapacity:[array count]];
-        for (NSString *string in array)
-            [result addObject:[string stringByAppendingString:@"!"]];
-        (void)[result copy];
-    }
-    stop();
+    WOBenchmarkRegister([WO_STRING(@"chain/%lu/lazy", (unsigned long)count) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            (void)[[[[[[array lazy] select:notMultipleOfThree] map:twice] reject:multipleOfFive]
+                    map:successor] allObjects];
+        }
+    });
+
+    WOBenchmarkRegister([WO_STRING(@"chain/%lu/eager, first 100", (unsigned long)count) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            NSArray *selected = selectNumbers(array, YES, notMultipleOfThree);
+            NSArray *doubled = [selected map:twice];
+            NSArray *rejected = selectNumbers(doubled, NO, multipleOfFive);
+            NSArray *mapped = [rejected map:successor];
+            (void)[mapped subarrayWithRange:NSMakeRange(0, MIN([mapped count], 100U))];
+        }
+    });
+
+    WOBenchmarkRegister([WO_STRING(@"chain/%lu/lazy, first 100", (unsigned long)count) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            (void)[[[[[[[array lazy] select:notMultipleOfThree] map:twice] reject:multipleOfFive]
+                     map:successor] take:100] allObjects];
+        }
+    });
+}
+
+// registers serial and parallel sums of count numbers
+static void registerReduceBenchmarks(NSUInteger count)
+{
+    WOBenchmarkSetUp numbers = ^{
+        NSMutableArray *array = [NSMutableArray arrayWithCapacity:count];
+        for (NSUInteger i = 0; i < count; i++)
+            [array addObject:[NSNumber numberWithUnsignedInteger:i]];
+        return (id)array;
+    };
+    id (^sum)(id, id) = ^(id memo, id n) {
+        return (id)[NSNumber numberWithUnsignedLongLong:[memo unsignedLongLongValue] + [n unsignedLongLongValue]];
+    };
+
+    WOBenchmarkRegister([WO_STRING(@"reduce/%lu/fast enumeration", (unsigned long)count) UTF8String], numbers,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            id memo = nil;
+            for (id n in array)
+                memo = memo ? sum(memo, n) : n;
+        }
+    });
+
+    WOBenchmarkRegister([WO_STRING(@"reduce/%lu/-[NSArray parallelInject:block:]", (unsigned long)count) UTF8String],
+                        numbers, ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+            (void)[array parallelInject:nil block:sum];
+    });
+}
+
+// registers sorts of count strings by an expensive key, computing it for
+// every comparison and once per element
+static void registerSortBenchmarks(NSUInteger count)
+{
+    WOBenchmarkSetUp strings = ^{
+        NSMutableArray *array = [NSMutableArray arrayWithCapacity:count];
+        for (NSUInteger i = 0; i < count; i++)
+            [array addObject:WO_STRING(@"object %lu", (unsigned long)((i * 7919) % count))];
+        return (id)array;
+    };
+
+    WOBenchmarkRegister([WO_STRING(@"sort/%lu/-[NSArray sortedArrayUsingComparator:]", (unsigned long)count)
+                         UTF8String], strings, ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            (void)[array sortedArrayUsingComparator:^(id a, id b) {
+                return [hashString(a) compare:hashString(b)];
+            }];
+        }
+    });
 
-    return EXIT_SUCCESS;
+    WOBenchmarkRegister([WO_STRING(@"sort/%lu/-[NSArray sortBy:]", (unsigned long)count) UTF8String], strings,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+            (void)[array sortBy:^(id string) { return hashString(string); }];
+    });
+}
+
+// registers hand-written bucketing of count numbers by a derived key against
+// groupBy: and tally:
+static void registerGroupBenchmarks(NSUInteger count, NSUInteger keyCount)
+{
+    WOBenchmarkSetUp setUp = ^{
+        NSMutableArray *array = [NSMutableArray arrayWithCapacity:count];
+        for (NSUInteger i = 0; i < count; i++)
+            [array addObject:[NSNumber numberWithUnsignedInteger:i]];
+        return (id)array;
+    };
+    id (^key)(id) = ^(id n) { return (id)[NSNumber numberWithUnsignedInteger:[n unsignedIntegerValue] % keyCount]; };
+    NSString *variant = WO_STRING(@"%lu/%lu keys", (unsigned long)count, (unsigned long)keyCount);
+
+    WOBenchmarkRegister([WO_STRING(@"group/%@/manual", variant) UTF8String], setUp, ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            NSMutableDictionary *groups = [NSMutableDictionary dictionary];
+            for (id n in array)
+            {
+                id k = key(n);
+                NSMutableArray *group = [groups objectForKey:k];
+                if (!group)
+                {
+                    group = [NSMutableArray array];
+                    [groups setObject:group forKey:k];
+                }
+                [group addObject:n];
+            }
+        }
+    });
+
+    WOBenchmarkRegister([WO_STRING(@"group/%@/-[NSArray groupBy:]", variant) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+            (void)[array groupBy:key];
+    });
+
+    WOBenchmarkRegister([WO_STRING(@"group/%@/manual tally", variant) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            NSMutableDictionary *tallies = [NSMutableDictionary dictionary];
+            for (id n in array)
+            {
+                id k = key(n);
+                NSNumber *tally = [tallies objectForKey:k];
+                [tallies setObject:[NSNumber numberWithUnsignedInteger:[tally unsignedIntegerValue] + 1] forKey:k];
+            }
+        }
+    });
+
+    WOBenchmarkRegister([WO_STRING(@"group/%@/-[NSArray tally:]", variant) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+            (void)[array tally:key];
+    });
+
+    WOBenchmarkRegister([WO_STRING(@"group/%@/-[NSArray partition:]", variant) UTF8String], setUp,
+                        ^(id array, uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; i++)
+            (void)[array partition:^(id n) { return (BOOL)([n unsignedIntegerValue] % 2 == 0); }];
+    });
+}
+
+WO_LOAD registerArrayBenchmarks(void)
+{
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    registerMapBenchmarks(WO_ONE_MILLION);
+    registerMapBenchmarks(WO_ONE_THOUSAND);
+    registerExpensiveMapBenchmarks(WO_ONE_THOUSAND * 10);
+    registerChainBenchmarks(WO_ONE_MILLION);
+    registerChainBenchmarks(WO_ONE_THOUSAND);
+    registerReduceBenchmarks(WO_ONE_MILLION);
+    registerSortBenchmarks(WO_ONE_THOUSAND * 10);
+    registerGroupBenchmarks(WO_ONE_MILLION, 10);
+    registerGroupBenchmarks(WO_ONE_MILLION, WO_ONE_THOUSAND * 10);
+    [pool drain];
+}
+
+int main(int argc, char *argv[])
+{
+    return WOBenchmarkMain(argc, argv);
 }
@@ -27,6 +27,9 @@
 // class header
 #import "NSArray+WORubyBlocksTest.h"
 
+// system headers
+#import <libkern/OSAtomic.h>    /* OSAtomicIncrement32Barrier() */
+
 // tested category header
 #import "NSArray+WORubyBlocks.h"
 
@@ -96,4 +99,166 @@
     }];
 }
 
+- (void)testParallelMap
+{
+    // empty array
+    WO_TEST_EQ([[NSArray array] parallelMap:^(id obj) { return (id)nil; }], [NSArray array]);
+
+    // order is preserved across chunks, whatever the grain size
+    NSMutableArray *array = [NSMutableArray array];
+    NSMutableArray *expected = [NSMutableArray array];
+    for (int i = 0; i < 10000; i++)
+    {
+        [array addObject:[NSNumber numberWithInt:i]];
+        [expected addObject:[NSNumber numberWithInt:i * 2]];
+    }
+    id (^doubler)(id) = ^(id obj) {
+        return (id)[NSNumber numberWithInt:[obj intValue] * 2];
+    };
+    WO_TEST_EQ([array parallelMap:doubler], expected);
+    WO_TEST_EQ([array map:doubler], [array parallelMap:doubler]);
+    for (NSUInteger grainSize = 1; grainSize <= 100000; grainSize *= 10)
+    {
+        NSArray *actual = [array parallelMap:^(id obj, BOOL *stop) {
+            return doubler(obj);
+        } grainSize:grainSize];
+        WO_TEST_EQ(actual, expected);
+    }
+
+    // NSNull singleton should be substituted for nil returned from block
+    NSArray *actual = [WO_ARRAY(@"foo", @"bar") parallelMap:^(id obj) {
+        return (id)([obj isEqualToString:@"bar"] ? obj : nil);
+    }];
+    WO_TEST_EQ(actual, WO_ARRAY([NSNull null], @"bar"));
+}
+
+- (void)testParallelMapCancellation
+{
+    NSMutableArray *array = [NSMutableArray array];
+    for (int i = 0; i < 10000; i++)
+        [array addObject:[NSNumber numberWithInt:i]];
+
+    // a stopped map returns nil
+    NSArray *actual = [array parallelMap:^(id obj, BOOL *stop) {
+        if ([obj intValue] == 5000)
+            *stop = YES;
+        return obj;
+    } grainSize:10];
+    WO_TEST_NIL(actual);
+
+    // exceptions are re-raised on the calling thread
+    WO_TEST_THROWS(([array parallelMap:^(id obj) {
+        if ([obj intValue] == 5000)
+            [NSException raise:NSGenericException format:@"element %@", obj];
+        return obj;
+    }]));
+}
+
+- (void)testParallelInject
+{
+    id (^sum)(id, id) = ^(id memo, id obj) {
+        return (id)[NSNumber numberWithInt:[memo intValue] + [obj intValue]];
+    };
+
+    // empty array gives back the initial value
+    WO_TEST_EQ([[NSArray array] parallelInject:WO_INT(7) block:sum], WO_INT(7));
+    WO_TEST_NIL([[NSArray array] parallelInject:nil block:sum]);
+
+    NSMutableArray *array = [NSMutableArray array];
+    for (int i = 1; i <= 1000; i++)
+        [array addObject:[NSNumber numberWithInt:i]];
+    WO_TEST_EQ([array parallelInject:nil block:sum], WO_INT(500500));
+    WO_TEST_EQ([array parallelInject:WO_INT(10) block:sum], WO_INT(500510));
+
+    // associative but not commutative: order must be preserved
+    NSMutableArray *strings = [NSMutableArray array];
+    NSMutableString *expected = [NSMutableString string];
+    for (int i = 0; i < 500; i++)
+    {
+        [strings addObject:WO_STRING(@"%d,", i)];
+        [expected appendFormat:@"%d,", i];
+    }
+    for (NSUInteger grainSize = 1; grainSize <= 1000; grainSize *= 7)
+    {
+        NSString *actual = [strings parallelInject:@"" block:^(id memo, id obj) {
+            return (id)[memo stringByAppendingString:obj];
+        } grainSize:grainSize];
+        WO_TEST_EQ(actual, expected);
+    }
+}
+
+- (void)testSortBy
+{
+    WO_TEST_EQ([[NSArray array] sortBy:^(id obj) { return obj; }], [NSArray array]);
+
+    // stable: equal keys keep their order
+    NSArray *words = WO_ARRAY(@"pear", @"fig", @"apple", @"kiwi", @"date", @"banana", @"yam");
+    NSArray *expected = WO_ARRAY(@"fig", @"yam", @"pear", @"kiwi", @"date", @"apple", @"banana");
+    WO_TEST_EQ([words sortBy:^(id obj) { return (id)WO_UNSIGNED([obj length]); }], expected);
+
+    // nil keys sort first
+    NSArray *actual = [words sortBy:^(id obj) { return (id)([obj length] == 4 ? nil : obj); }];
+    WO_TEST_EQ(actual, WO_ARRAY(@"pear", @"kiwi", @"date", @"apple", @"banana", @"fig", @"yam"));
+
+    // large enough for several chunks and merge rounds; each key computed once
+    NSMutableArray *numbers = [NSMutableArray array];
+    for (int i = 0; i < 10000; i++)
+        [numbers addObject:[NSNumber numberWithInt:(i * 7919) % 10007]];
+    __block volatile int32_t calls = 0;
+    NSArray *sorted = [numbers sortBy:^(id obj) {
+        OSAtomicIncrement32Barrier(&calls);
+        return (id)[NSNumber numberWithInt:-[obj intValue]];
+    }];
+    WO_TEST_EQ(calls, 10000);
+    WO_TEST_EQ([sorted count], [numbers count]);
+    WO_TEST_EQ(sorted, [numbers sortedArrayUsingComparator:^(id a, id b) { return [b compare:a]; }]);
+}
+
+- (void)testGroupBy
+{
+    WO_TEST_EQ([[NSArray array] groupBy:^(id obj) { return obj; }], [NSDictionary dictionary]);
+
+    NSArray *words = WO_ARRAY(@"pear", @"fig", @"apple", @"kiwi", @"yam");
+    NSDictionary *expected = [NSDictionary dictionaryWithObjectsAndKeys:
+                              WO_ARRAY(@"pear", @"kiwi"), WO_UNSIGNED(4),
+                              WO_ARRAY(@"fig", @"yam"),   WO_UNSIGNED(3),
+                              WO_ARRAY(@"apple"),         WO_UNSIGNED(5),
+                              nil];
+    WO_TEST_EQ([words groupBy:^(id obj) { return (id)WO_UNSIGNED([obj length]); }], expected);
+
+    // nil keys grouped under NSNull; each key computed once
+    __block int calls = 0;
+    NSDictionary *actual = [words groupBy:^(id obj) {
+        calls++;
+        return (id)([obj length] == 3 ? nil : @"other");
+    }];
+    WO_TEST_EQ(calls, 5);
+    WO_TEST_EQ([actual objectForKey:[NSNull null]], WO_ARRAY(@"fig", @"yam"));
+    WO_TEST_EQ([actual objectForKey:@"other"], WO_ARRAY(@"pear", @"apple", @"kiwi"));
+}
+
+- (void)testPartition
+{
+    WO_TEST_EQ([[NSArray array] partition:^(id obj) { return YES; }], WO_ARRAY([NSArray array], [NSArray array]));
+
+    NSArray *words = WO_ARRAY(@"pear", @"fig", @"apple", @"kiwi", @"yam");
+    NSArray *actual = [words partition:^(id obj) { return (BOOL)([obj length] == 4); }];
+    WO_TEST_EQ(actual, WO_ARRAY(WO_ARRAY(@"pear", @"kiwi"), WO_ARRAY(@"fig", @"apple", @"yam")));
+    actual = [words partition:^(id obj) { return NO; }];
+    WO_TEST_EQ(actual, WO_ARRAY([NSArray array], words));
+}
+
+- (void)testTally
+{
+    WO_TEST_EQ([[NSArray array] tally:^(id obj) { return obj; }], [NSDictionary dictionary]);
+
+    NSArray *words = WO_ARRAY(@"pear", @"fig", @"apple", @"kiwi", @"yam", @"date");
+    NSDictionary *expected = [NSDictionary dictionaryWithObjectsAndKeys:
+                              WO_UNSIGNED(3), WO_UNSIGNED(4),
+                              WO_UNSIGNED(2), WO_UNSIGNED(3),
+                              WO_UNSIGNED(1), WO_UNSIGNED(5),
+                              nil];
+    WO_TEST_EQ([words tally:^(id obj) { return (id)WO_UNSIGNED([obj length]); }], expected);
+}
+
 @end
@@ -0,0 +1,113 @@
+// WOAllocationMeterTests.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOAllocationMeterTests.h"
+
+// system headers
+#import <objc/runtime.h>        /* class_getInstanceSize() */
+
+// tested class headers
+#import "WOAllocationMeter.h"
+
+@implementation WOAllocationMeterTests
+
+- (void)testCounting
+{
+    WOAllocationMeter *meter = [WOAllocationMeter allocationMeter];
+    void *pointers[100];
+    for (unsigned i = 0; i < 100; i++)
+        pointers[i] = malloc(64);
+    for (unsigned i = 0; i < 100; i++)
+        free(pointers[i]);
+    [meter pause];
+
+    WOAllocationCounts counts = [meter counts];
+    if (![WOAllocationMeter isSupported])
+    {
+        WO_TEST_EQ(counts.allocations, 0LL);
+        WO_TEST_EQ(counts.frees, 0LL);
+        WO_TEST_TRUE([[meter countsString] rangeOfString:@"unavailable"].location != NSNotFound);
+        return;
+    }
+    WO_TEST_TRUE(counts.allocations >= 100);
+    WO_TEST_TRUE(counts.frees >= 100);
+    WO_TEST_TRUE(counts.bytesAllocated >= 100 * 64);
+    WO_TEST_TRUE(counts.bytesFreed >= 100 * 64);
+
+    // paused meter does not advance
+    free(malloc(64));
+    WO_TEST_EQ([meter counts].allocations, counts.allocations);
+
+    // stacked resume/pause
+    [meter resume];
+    [meter resume];
+    [meter pause];
+    free(malloc(64));
+    [meter pause];
+    WO_TEST_TRUE([meter counts].allocations >= counts.allocations + 1);
+    WO_TEST_TRUE([[[meter countsDictionary] objectForKey:@"allocations"] isKindOfClass:[NSNumber class]]);
+}
+
+- (void)testObjectAllocations
+{
+    if (![WOAllocationMeter isSupported])
+        return;
+
+    // collectable objects are counted too, not only malloc() blocks
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:100];
+    WOAllocationMeter *meter = [WOAllocationMeter allocationMeter];
+    for (unsigned i = 0; i < 100; i++)
+        [objects addObject:[[NSObject alloc] init]];
+    NSArray *copy = [objects copy];
+    [meter pause];
+    WOAllocationCounts counts = [meter counts];
+    WO_TEST_TRUE(counts.allocations >= 101);
+    WO_TEST_TRUE(counts.bytesAllocated >= (int64_t)(100 * class_getInstanceSize([NSObject class])));
+    WO_TEST_EQ([copy count], (NSUInteger)100);
+}
+
+- (void)testOtherThreadsNotCounted
+{
+    WOAllocationMeter *meter = [WOAllocationMeter allocationMeter];
+    [meter pause];
+    int64_t allocations = [meter counts].allocations;
+    [meter resume];
+    [NSThread detachNewThreadSelector:@selector(allocate:) toTarget:self withObject:nil];
+    [NSThread sleepForTimeInterval:0.1];
+    [meter pause];
+
+    // the sleep itself may allocate, but nowhere near as much as the thread
+    WO_TEST_TRUE([meter counts].allocations - allocations < 1000);
+}
+
+- (void)allocate:(id)ignored
+{
+    for (unsigned i = 0; i < 10000; i++)
+        free(malloc(16));
+}
+
+@end
@@ -0,0 +1,120 @@
+// WOHistogramTests.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOHistogramTests.h"
+
+// system headers
+#import <unistd.h>      /* usleep() */
+
+// tested class headers
+#import "WOHistogram.h"
+
+@implementation WOHistogramTests
+
+- (void)testEmpty
+{
+    WOHistogram *histogram = [WOHistogram histogram];
+    WO_TEST_EQ([histogram count], 0ULL);
+    WO_TEST_EQ([histogram valueAtPercentile:50.0], 0LL);
+    WOHistogramSummary summary = [histogram summary];
+    WO_TEST_EQ(summary.count, 0ULL);
+    WO_TEST_EQ(summary.maximum, 0LL);
+    WO_TEST_EQ(summary.p999, 0LL);
+}
+
+- (void)testPercentiles
+{
+    WOHistogram *histogram = [WOHistogram histogram];
+    for (WONanoseconds value = 1; value <= 100000; value++)
+        [histogram recordValue:value];
+    WOHistogramSummary summary = [histogram summary];
+    WO_TEST_EQ(summary.count, 100000ULL);
+    WO_TEST_EQ(summary.minimum, 1LL);
+    WO_TEST_EQ(summary.maximum, 100000LL);
+    WO_TEST_TRUE(summary.mean > 50000.0 && summary.mean < 50001.0);
+
+    // reported values are never below the true value and within 1/64 above it
+    WO_TEST_TRUE(summary.p50 >= 50000 && summary.p50 <= 50000 + 50000 / 64);
+    WO_TEST_TRUE(summary.p90 >= 90000 && summary.p90 <= 90000 + 90000 / 64);
+    WO_TEST_TRUE(summary.p99 >= 99000 && summary.p99 <= 99000 + 99000 / 64);
+    WO_TEST_TRUE(summary.p999 >= 99900 && summary.p999 <= 100000);
+    WO_TEST_EQ([histogram valueAtPercentile:50.0], summary.p50);
+    WO_TEST_EQ([histogram valueAtPercentile:0.0], 1LL);
+    WO_TEST_EQ([histogram valueAtPercentile:100.0], 100000LL);
+}
+
+- (void)testSmallValuesAreExact
+{
+    WOHistogram *histogram = [WOHistogram histogram];
+    for (unsigned i = 0; i < 10; i++)
+        [histogram recordValue:42];
+    [histogram recordValue:7];
+    WO_TEST_EQ([histogram valueAtPercentile:50.0], 42LL);
+    WO_TEST_EQ([histogram summary].minimum, 7LL);
+}
+
+- (void)testClamping
+{
+    WOHistogram *histogram = [WOHistogram histogram];
+    [histogram recordValue:-5];
+    [histogram recordValue:WO_HISTOGRAM_MAX_VALUE + 1000];
+    WOHistogramSummary summary = [histogram summary];
+    WO_TEST_EQ(summary.count, 2ULL);
+    WO_TEST_EQ(summary.minimum, 0LL);
+    WO_TEST_EQ(summary.maximum, WO_HISTOGRAM_MAX_VALUE);
+}
+
+- (void)testReset
+{
+    WOHistogram *histogram = [WOHistogram histogram];
+    [histogram recordValue:1000];
+    [histogram reset];
+    WO_TEST_EQ([histogram count], 0ULL);
+    [histogram recordValue:10];
+    WO_TEST_EQ([histogram summary].maximum, 10LL);
+}
+
+- (void)recordFromThread:(WOHistogram *)histogram
+{
+    for (WONanoseconds value = 1; value <= 10000; value++)
+        WOHistogramRecord(histogram, value);
+}
+
+- (void)testConcurrentRecording
+{
+    WOHistogram *histogram = [WOHistogram histogram];
+    for (unsigned i = 0; i < 8; i++)
+        [NSThread detachNewThreadSelector:@selector(recordFromThread:) toTarget:self withObject:histogram];
+    for (unsigned i = 0; i < 100 && [histogram count] < 80000ULL; i++)
+        usleep(50000);
+    WOHistogramSummary summary = [histogram summary];
+    WO_TEST_EQ(summary.count, 80000ULL);
+    WO_TEST_EQ(summary.maximum, 10000LL);
+    WO_TEST_TRUE(summary.p50 >= 5000 && summary.p50 <= 5000 + 5000 / 64);
+}
+
+@end
@@ -0,0 +1,119 @@
+// WOLazyEnumeratorTests.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#import "WOLazyEnumeratorTests.h"
+
+// tested class headers
+#import "WOLazyEnumerator.h"
+
+// tested category headers
+#import "NSArray+WORubyBlocks.h"
+
+@implementation WOLazyEnumeratorTests
+
+- (NSArray *)numbersTo:(int)max
+{
+    NSMutableArray *numbers = [NSMutableArray array];
+    for (int i = 1; i <= max; i++)
+        [numbers addObject:[NSNumber numberWithInt:i]];
+    return numbers;
+}
+
+- (void)testNoStages
+{
+    WO_TEST_EQ([[[NSArray array] lazy] allObjects], [NSArray array]);
+    WO_TEST_EQ([[[self numbersTo:3] lazy] allObjects], [self numbersTo:3]);
+}
+
+- (void)testSelectRejectMap
+{
+    WOLazyEnumerator *evens = [[[self numbersTo:10] lazy] select:^(id n) { return (BOOL)([n intValue] % 2 == 0); }];
+    WO_TEST_EQ([evens allObjects], WO_ARRAY(WO_INT(2), WO_INT(4), WO_INT(6), WO_INT(8), WO_INT(10)));
+
+    WOLazyEnumerator *odds = [[[self numbersTo:10] lazy] reject:^(id n) { return (BOOL)([n intValue] % 2 == 0); }];
+    WO_TEST_EQ([odds allObjects], WO_ARRAY(WO_INT(1), WO_INT(3), WO_INT(5), WO_INT(7), WO_INT(9)));
+
+    // stages are added to a new enumerator, leaving the original usable
+    WOLazyEnumerator *squares = [evens map:^(id n) { return (id)WO_INT([n intValue] * [n intValue]); }];
+    WO_TEST_EQ([squares allObjects], WO_ARRAY(WO_INT(4), WO_INT(16), WO_INT(36), WO_INT(64), WO_INT(100)));
+    WO_TEST_EQ([[evens allObjects] count], (NSUInteger)5);
+
+    // NSNull substituted for nil, as in -[NSArray map:]
+    WO_TEST_EQ([[[WO_ARRAY(@"foo") lazy] map:^(id obj) { return (id)nil; }] allObjects], WO_ARRAY([NSNull null]));
+}
+
+- (void)testTake
+{
+    NSArray *numbers = [self numbersTo:10];
+    WO_TEST_EQ([[[numbers lazy] take:3] allObjects], WO_ARRAY(WO_INT(1), WO_INT(2), WO_INT(3)));
+    WO_TEST_EQ([[[numbers lazy] take:0] allObjects], [NSArray array]);
+    WO_TEST_EQ([[[numbers lazy] take:20] allObjects], numbers);
+
+    // the pass ends as soon as take is satisfied
+    __block int calls = 0;
+    NSArray *taken = [[[[numbers lazy] map:^(id n) {
+        calls++;
+        return n;
+    }] take:2] allObjects];
+    WO_TEST_EQ([taken count], (NSUInteger)2);
+    WO_TEST_EQ(calls, 2);
+
+    WOLazyEnumerator *small = [[numbers lazy] takeWhile:^(id n) { return (BOOL)([n intValue] < 4); }];
+    WO_TEST_EQ([small allObjects], WO_ARRAY(WO_INT(1), WO_INT(2), WO_INT(3)));
+}
+
+- (void)testEachSlice
+{
+    NSArray *numbers = [self numbersTo:5];
+    NSArray *expected = WO_ARRAY(WO_ARRAY(WO_INT(1), WO_INT(2)), WO_ARRAY(WO_INT(3), WO_INT(4)), WO_ARRAY(WO_INT(5)));
+    WO_TEST_EQ([[[numbers lazy] eachSlice:2] allObjects], expected);
+    WO_TEST_THROWS([[numbers lazy] eachSlice:0]);
+
+    // partial slice downstream of a finished take is still passed on
+    expected = WO_ARRAY(WO_ARRAY(WO_INT(1), WO_INT(2)), WO_ARRAY(WO_INT(3)));
+    WO_TEST_EQ([[[[numbers lazy] take:3] eachSlice:2] allObjects], expected);
+
+    // but one upstream of it is not
+    expected = WO_ARRAY(WO_ARRAY(WO_INT(1), WO_INT(2)));
+    WO_TEST_EQ([[[[numbers lazy] eachSlice:2] take:1] allObjects], expected);
+}
+
+- (void)testTerminalOperations
+{
+    WOLazyEnumerator *evens = [[[self numbersTo:10] lazy] select:^(id n) { return (BOOL)([n intValue] % 2 == 0); }];
+    id sum = [evens inject:WO_INT(0) block:^(id memo, id n) {
+        return (id)WO_INT([memo intValue] + [n intValue]);
+    }];
+    WO_TEST_EQ(sum, WO_INT(30));
+
+    // enumerators can be run repeatedly
+    __block int count = 0;
+    [evens each:^(id n) { count++; }];
+    [evens each:^(id n) { count++; }];
+    WO_TEST_EQ(count, 10);
+}
+
+@end
@@ -0,0 +1,142 @@
+// WOLogFlightRecorderTests.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOLogFlightRecorderTests.h"
+
+// system headers
+#import <asl.h>
+
+// tested class headers
+#import "WOLogFlightRecorder.h"
+#import "WOLogManager.h"
+
+@implementation WOLogFlightRecorderTests
+
+- (NSString *)temporaryPath
+{
+    NSString *name = WO_STRING(@"WOLogFlightRecorderTests-%d-%@", getpid(), [[NSProcessInfo processInfo] globallyUniqueString]);
+    return [NSTemporaryDirectory() stringByAppendingPathComponent:name];
+}
+
+- (void)testInitialization
+{
+    WO_TEST_THROWS([[WOLogFlightRecorder alloc] initWithPath:nil capacity:4096]);
+    WO_TEST_NIL([[WOLogFlightRecorder alloc] initWithPath:@"/nonexistent/directory/recorder" capacity:4096]);
+    WO_TEST_NIL([WOLogFlightRecorder recordsInFile:@"/nonexistent/directory/recorder"]);
+}
+
+- (void)testWraparound
+{
+    NSString *path = [self temporaryPath];
+    WOLogFlightRecorder *recorder = [[WOLogFlightRecorder alloc] initWithPath:path capacity:4096];
+    WO_TEST_NOT_NIL(recorder);
+
+    // ~20 bytes per record plus framing: far more than fits in 4096 bytes
+    for (unsigned i = 0; i < 1000; i++)
+    {
+        const char *bytes = [WO_STRING(@"record %u", i) UTF8String];
+        [recorder recordBytes:bytes length:strlen(bytes) level:(i % 2 ? ASL_LEVEL_DEBUG : ASL_LEVEL_ERR)];
+    }
+
+    // same result from the live recorder and from the file (as after a crash)
+    for (NSArray *records in WO_ARRAY([recorder records], [WOLogFlightRecorder recordsInFile:path]))
+    {
+        WO_TEST_TRUE([records count] > 100);
+        WO_TEST_TRUE([records count] < 1000);
+
+        // the most recent window, in order, with no gaps
+        NSUInteger first = 1000 - [records count];
+        for (NSUInteger i = 0; i < [records count]; i++)
+        {
+            WOLogRecord *record = [records objectAtIndex:i];
+            NSString *string = [[NSString alloc] initWithData:[record data] encoding:NSUTF8StringEncoding];
+            WO_TEST_EQ(string, WO_STRING(@"record %lu", (unsigned long)(first + i)));
+            WO_TEST_EQ([record level], (unsigned)((first + i) % 2 ? ASL_LEVEL_DEBUG : ASL_LEVEL_ERR));
+        }
+    }
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+- (void)testReopenPreservesPreviousRecording
+{
+    NSString *path      = [self temporaryPath];
+    NSString *previous  = [WOLogFlightRecorder previousPathForPath:path];
+    WOLogFlightRecorder *recorder = [[WOLogFlightRecorder alloc] initWithPath:path capacity:4096];
+    WO_TEST_NOT_NIL(recorder);
+    for (unsigned i = 0; i < 3; i++)
+    {
+        const char *bytes = [WO_STRING(@"old %u", i) UTF8String];
+        [recorder recordBytes:bytes length:strlen(bytes) level:ASL_LEVEL_ERR];
+    }
+
+    // as when a restarted process starts recording at the same path
+    WOLogFlightRecorder *reopened = [[WOLogFlightRecorder alloc] initWithPath:path capacity:4096];
+    WO_TEST_NOT_NIL(reopened);
+    WO_TEST_EQ([[reopened records] count], (NSUInteger)0);
+    NSArray *records = [WOLogFlightRecorder recordsInFile:previous];
+    WO_TEST_EQ([records count], (NSUInteger)3);
+    for (NSUInteger i = 0; i < [records count]; i++)
+    {
+        NSString *string = [[NSString alloc] initWithData:[[records objectAtIndex:i] data] encoding:NSUTF8StringEncoding];
+        WO_TEST_EQ(string, WO_STRING(@"old %lu", (unsigned long)i));
+    }
+
+    // the new recording does not disturb the previous one
+    [reopened recordBytes:"new" length:3 level:ASL_LEVEL_ERR];
+    WO_TEST_EQ([[WOLogFlightRecorder recordsInFile:path] count], (NSUInteger)1);
+    WO_TEST_EQ([[WOLogFlightRecorder recordsInFile:previous] count], (NSUInteger)3);
+    WO_TEST_THROWS([WOLogFlightRecorder previousPathForPath:nil]);
+
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+    [[NSFileManager defaultManager] removeItemAtPath:previous error:NULL];
+}
+
+- (void)testManagerRecordsAllLevels
+{
+    NSString *path = [self temporaryPath];
+    WOLogFlightRecorder *recorder = [[WOLogFlightRecorder alloc] initWithPath:path capacity:65536];
+    unsigned level = [WOLog logLevel];
+    [WOLog setLogLevel:ASL_LEVEL_ERR];
+    [WOLog setFlightRecorder:recorder];
+    WO_TEST_TRUE(WOLogCategoryEnabled(WO_LOG_DEFAULT_CATEGORY, ASL_LEVEL_DEBUG));
+    [WOLog logLevel:ASL_LEVEL_DEBUG message:@"flight %d", 1];
+    WO_LOG_CATEGORY(WO_LOG_DEFAULT_CATEGORY, ASL_LEVEL_INFO, @"flight %d", 2);
+    [WOLog setFlightRecorder:nil];
+    WO_TEST_FALSE(WOLogCategoryEnabled(WO_LOG_DEFAULT_CATEGORY, ASL_LEVEL_DEBUG));
+    [WOLog logLevel:ASL_LEVEL_DEBUG message:@"not recorded"];
+    [WOLog setLogLevel:level];
+
+    NSArray *records = [WOLogFlightRecorder recordsInFile:path];
+    WO_TEST_EQ([records count], (NSUInteger)2);
+    NSString *line = [[NSString alloc] initWithData:[[records objectAtIndex:0] data] encoding:NSUTF8StringEncoding];
+    WO_TEST_TRUE([line hasSuffix:@"flight 1\n"]);
+    line = [[NSString alloc] initWithData:[[records objectAtIndex:1] data] encoding:NSUTF8StringEncoding];
+    WO_TEST_TRUE([line hasSuffix:@"flight 2\n"]);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+@end
@@ -0,0 +1,207 @@
+// WOLogManagerTests.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOLogManagerTests.h"
+
+// system headers
+#import <asl.h>
+
+// tested class headers
+#import "WOLogManager.h"
+#import "WOLogMemorySink.h"
+
+@implementation WOLogManagerTests
+
+//! Each site must be reached repeatedly, so they live in helper methods.
+- (void)logSiteWarning:(int)number object:(id)object
+{
+    WO_LOG_SITE_WARNING(ASL_LEVEL_ERR, "site %d %@ %.2f %s %%", number, object, 1.5, "c");
+}
+
+- (void)logSiteDebug
+{
+    WO_LOG_SITE_DEBUG("debug site");
+}
+
+- (void)logSiteInCategory:(WOLogCategory)category
+{
+    WO_LOG_SITE_CATEGORY(category, ASL_LEVEL_INFO, "category site %d", 1);
+}
+
+- (void)logSiteWithObjectWidth
+{
+    WO_LOG_SITE(ASL_LEVEL_ERR, "%10@", @"padded");
+}
+
+- (NSString *)lastLineInSink:(WOLogMemorySink *)sink
+{
+    NSData *data = [[[sink records] lastObject] data];
+    return data ? [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] : nil;
+}
+
+- (void)testRegisterCategory
+{
+    // should raise exception if passed nil
+    WO_TEST_THROWS([WOLog registerCategory:nil]);
+    WO_TEST_THROWS_EXCEPTION_NAMED([WOLog registerCategory:nil], NSInternalInconsistencyException);
+
+    // registering the same name twice should return the same handle
+    WOLogCategory a = [WOLog registerCategory:@"WOLogManagerTests.a"];
+    WOLogCategory b = [WOLog registerCategory:@"WOLogManagerTests.b"];
+    WO_TEST_NE(a, b);
+    WO_TEST_EQ([WOLog registerCategory:@"WOLogManagerTests.a"], a);
+    WO_TEST_EQ([WOLog nameForCategory:a], @"WOLogManagerTests.a");
+
+    // default category is always present
+    WO_TEST_EQ([WOLog nameForCategory:WO_LOG_DEFAULT_CATEGORY], WO_LOG_DEFAULT_CATEGORY_NAME);
+    WO_TEST_EQ([WOLog registerCategory:WO_LOG_DEFAULT_CATEGORY_NAME], WO_LOG_DEFAULT_CATEGORY);
+}
+
+- (void)testCategoryLevels
+{
+    WOLogCategory category = [WOLog registerCategory:@"WOLogManagerTests.levels"];
+    [WOLog setLevel:ASL_LEVEL_ERR forCategory:category];
+    WO_TEST_EQ([WOLog levelForCategory:category], (unsigned)ASL_LEVEL_ERR);
+    WO_TEST_TRUE(WOLogCategoryEnabled(category, ASL_LEVEL_ERR));
+    WO_TEST_FALSE(WOLogCategoryEnabled(category, ASL_LEVEL_DEBUG));
+
+    // changing one category should not affect another
+    WOLogCategory other = [WOLog registerCategory:@"WOLogManagerTests.other"];
+    [WOLog setLevel:ASL_LEVEL_DEBUG forCategory:other];
+    WO_TEST_FALSE(WOLogCategoryEnabled(category, ASL_LEVEL_DEBUG));
+    WO_TEST_TRUE(WOLogCategoryEnabled(other, ASL_LEVEL_DEBUG));
+
+    // default category should mirror logLevel
+    unsigned level = [WOLog logLevel];
+    [WOLog setLogLevel:ASL_LEVEL_INFO];
+    WO_TEST_EQ([WOLog levelForCategory:WO_LOG_DEFAULT_CATEGORY], (unsigned)ASL_LEVEL_INFO);
+    [WOLog setLevel:ASL_LEVEL_NOTICE forCategory:WO_LOG_DEFAULT_CATEGORY];
+    WO_TEST_EQ([WOLog logLevel], (unsigned)ASL_LEVEL_NOTICE);
+    [WOLog setLogLevel:level];
+}
+
+- (void)testApplyCategoryLevels
+{
+    WOLogCategory category = [WOLog registerCategory:@"WOLogManagerTests.apply"];
+    [WOLog applyCategoryLevels:@"WOLogManagerTests.apply=2, WOLogManagerTests.later=7"];
+    WO_TEST_EQ([WOLog levelForCategory:category], 2U);
+
+    // overrides for unregistered names should apply on registration
+    WOLogCategory later = [WOLog registerCategory:@"WOLogManagerTests.later"];
+    WO_TEST_EQ([WOLog levelForCategory:later], 7U);
+
+    // malformed entries should be skipped without affecting valid ones
+    [WOLog applyCategoryLevels:@"WOLogManagerTests.apply=x =3 WOLogManagerTests.apply WOLogManagerTests.apply=4"];
+    WO_TEST_EQ([WOLog levelForCategory:category], 4U);
+}
+
+- (void)testLogSites
+{
+    WOLogMemorySink *sink = [[WOLogMemorySink alloc] init];
+    unsigned level = [WOLog logLevel];
+    [WOLog setLogLevel:ASL_LEVEL_ERR];
+    [WOLog addSink:sink];
+
+    // format arguments applied from the precompiled layout
+    [self logSiteWarning:1 object:@"one"];
+    WO_TEST_TRUE([[self lastLineInSink:sink] hasSuffix:@"Warning: site 1 one 1.50 c %\n"]);
+
+    // below the log level: site disabled
+    [self logSiteDebug];
+    WO_TEST_EQ([[sink records] count], (NSUInteger)1);
+
+    // level changes are pushed to registered sites
+    [WOLog setLogLevel:ASL_LEVEL_DEBUG];
+    [self logSiteDebug];
+    WO_TEST_EQ([[sink records] count], (NSUInteger)2);
+    WO_TEST_TRUE([[self lastLineInSink:sink] hasSuffix:@"debug site\n"]);
+
+    // switched off at runtime, then back on
+    [WOLog setEnabled:NO forLogSitesInFile:[[NSString stringWithUTF8String:__FILE__] lastPathComponent] line:0];
+    [self logSiteWarning:2 object:@"two"];
+    [self logSiteDebug];
+    WO_TEST_EQ([[sink records] count], (NSUInteger)2);
+    [WOLog setEnabled:YES forLogSitesInFile:[NSString stringWithUTF8String:__FILE__] line:0];
+    [self logSiteWarning:3 object:@"three"];
+    WO_TEST_EQ([[sink records] count], (NSUInteger)3);
+    WO_TEST_TRUE([[self lastLineInSink:sink] hasSuffix:@"Warning: site 3 three 1.50 c %\n"]);
+    WO_TEST_THROWS([WOLog setEnabled:YES forLogSitesInFile:nil line:0]);
+
+    [WOLog removeSink:sink];
+    [WOLog setLogLevel:level];
+}
+
+- (void)testLogSiteCategories
+{
+    WOLogMemorySink *sink = [[WOLogMemorySink alloc] init];
+    WOLogCategory category = [WOLog registerCategory:@"WOLogManagerTests.sites"];
+    [WOLog setLevel:ASL_LEVEL_ERR forCategory:category];
+    [WOLog addSink:sink];
+
+    // enabled by the category's level, not the default one
+    [self logSiteInCategory:category];
+    WO_TEST_EQ([[sink records] count], (NSUInteger)0);
+    [WOLog setLevel:ASL_LEVEL_INFO forCategory:category];
+    [self logSiteInCategory:category];
+    WO_TEST_EQ([[sink records] count], (NSUInteger)1);
+    WO_TEST_TRUE([[self lastLineInSink:sink] hasSuffix:@"[WOLogManagerTests.sites] category site 1\n"]);
+
+    // %@ takes no flags, width or precision
+    WO_TEST_THROWS([self logSiteWithObjectWidth]);
+
+    [WOLog removeSink:sink];
+}
+
+- (void)testThrottleSample
+{
+    // throttles must be static: sites that drop messages join a global list
+    static WOLogThrottle throttle = WO_LOG_THROTTLE_SAMPLED(3);
+    WO_TEST_TRUE(WOLogThrottleSample(&throttle, ASL_LEVEL_ERR));    // first message always logged
+    WO_TEST_FALSE(WOLogThrottleSample(&throttle, ASL_LEVEL_ERR));
+    WO_TEST_FALSE(WOLogThrottleSample(&throttle, ASL_LEVEL_ERR));
+    WO_TEST_TRUE(WOLogThrottleSample(&throttle, ASL_LEVEL_ERR));
+    WO_TEST_EQ(throttle.suppressed, 2);
+
+    // summary should reset the count
+    [WOLog logSuppressionSummaries];
+    WO_TEST_EQ(throttle.suppressed, 0);
+}
+
+- (void)testThrottleAcquire
+{
+    // one message per hour with a burst of 3: the first 3 get through
+    static WOLogThrottle throttle = { .file = __FILE__, .line = __LINE__,
+        .emissionInterval = 3600 * 1000000000LL, .tolerance = 2 * 3600 * 1000000000LL };
+    WO_TEST_TRUE(WOLogThrottleAcquire(&throttle, ASL_LEVEL_ERR));
+    WO_TEST_TRUE(WOLogThrottleAcquire(&throttle, ASL_LEVEL_ERR));
+    WO_TEST_TRUE(WOLogThrottleAcquire(&throttle, ASL_LEVEL_ERR));
+    WO_TEST_FALSE(WOLogThrottleAcquire(&throttle, ASL_LEVEL_ERR));
+    WO_TEST_FALSE(WOLogThrottleAcquire(&throttle, ASL_LEVEL_ERR));
+    WO_TEST_EQ(throttle.suppressed, 2);
+}
+
+@end
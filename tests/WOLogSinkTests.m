@@ -0,0 +1,173 @@
+// WOLogSinkTests.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOLogSinkTests.h"
+
+// system headers
+#import <asl.h>
+
+// tested class headers
+#import "WOLogFileSink.h"
+#import "WOLogManager.h"
+#import "WOLogMemorySink.h"
+#import "WOLogSink.h"
+
+#pragma mark -
+#pragma mark Helper classes
+
+//! Sink whose writes block until the test releases them.
+@interface WOStalledLogSink : WOLogSink {
+
+@public
+    dispatch_semaphore_t release;
+
+}
+
+@end
+
+@implementation WOStalledLogSink
+
+- (void)writeRecord:(WOLogRecord *)record
+{
+    dispatch_semaphore_wait(release, DISPATCH_TIME_FOREVER);
+}
+
+@end
+
+#pragma mark -
+
+@implementation WOLogSinkTests
+
+- (void)testRecord
+{
+    WO_TEST_THROWS([[WOLogRecord alloc] initWithData:nil level:ASL_LEVEL_ERR]);
+    NSData *data = [@"hello\n" dataUsingEncoding:NSUTF8StringEncoding];
+    WOLogRecord *record = [[WOLogRecord alloc] initWithData:data level:ASL_LEVEL_ERR];
+    WO_TEST_EQ([record data], data);
+    WO_TEST_EQ([record level], (unsigned)ASL_LEVEL_ERR);
+}
+
+- (void)testMemorySink
+{
+    WOLogMemorySink *sink = [[WOLogMemorySink alloc] initWithCapacity:2];
+    [sink setMinimumLevel:ASL_LEVEL_WARNING];
+    for (NSString *string in WO_ARRAY(@"a", @"b", @"c"))
+        [sink submitRecord:[[WOLogRecord alloc] initWithData:[string dataUsingEncoding:NSUTF8StringEncoding]
+                                                       level:ASL_LEVEL_ERR]];
+
+    // below minimum level: should be ignored
+    [sink submitRecord:[[WOLogRecord alloc] initWithData:[@"d" dataUsingEncoding:NSUTF8StringEncoding]
+                                                   level:ASL_LEVEL_DEBUG]];
+
+    // oldest record should have been discarded
+    NSArray *records = [sink records];
+    WO_TEST_EQ([records count], (NSUInteger)2);
+    WO_TEST_EQ([[records objectAtIndex:0] data], [@"b" dataUsingEncoding:NSUTF8StringEncoding]);
+    WO_TEST_EQ([[records objectAtIndex:1] data], [@"c" dataUsingEncoding:NSUTF8StringEncoding]);
+}
+
+- (void)testStalledSinkDoesNotBlock
+{
+    WOStalledLogSink *stalled = [[WOStalledLogSink alloc] init];
+    stalled->release = dispatch_semaphore_create(0);
+    [stalled setMaximumPendingRecords:4];
+    WOLogMemorySink *memory = [[WOLogMemorySink alloc] init];
+
+    // records beyond the pending limit should be dropped, not queued
+    NSData *data = [@"x\n" dataUsingEncoding:NSUTF8StringEncoding];
+    for (unsigned i = 0; i < 10; i++)
+    {
+        WOLogRecord *record = [[WOLogRecord alloc] initWithData:data level:ASL_LEVEL_ERR];
+        [stalled submitRecord:record];
+        [memory submitRecord:record];
+    }
+    WO_TEST_EQ([stalled droppedRecordCount], 6LL);
+
+    // other sinks should be unaffected
+    WO_TEST_EQ([[memory records] count], (NSUInteger)10);
+
+    for (unsigned i = 0; i < 4; i++)
+        dispatch_semaphore_signal(stalled->release);
+    [stalled flush];
+    dispatch_release(stalled->release);
+}
+
+- (void)testFileSinkFragments
+{
+    WO_TEST_THROWS([WOLogFileSink reassembleData:nil]);
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:
+                      WO_STRING(@"WOLogSinkTests-%@.log", [[NSProcessInfo processInfo] globallyUniqueString])];
+    WOLogFileSink *sink = [[WOLogFileSink alloc] initWithPath:path];
+
+    // short record: written as is
+    NSMutableData *expected = [NSMutableData data];
+    NSData *shortRecord = [@"short\n" dataUsingEncoding:NSUTF8StringEncoding];
+    WO_TEST_TRUE([sink appendBytes:[shortRecord bytes] length:[shortRecord length]]);
+    [expected appendData:shortRecord];
+
+    // long record: split into fragments
+    NSMutableString *longString = [NSMutableString string];
+    while ([longString length] < 3 * WO_LOG_ATOMIC_APPEND_SIZE)
+        [longString appendFormat:@"%lu ", (unsigned long)[longString length]];
+    [longString appendString:@"\n"];
+    NSData *longRecord = [longString dataUsingEncoding:NSUTF8StringEncoding];
+    WO_TEST_TRUE([sink appendBytes:[longRecord bytes] length:[longRecord length]]);
+    [expected appendData:longRecord];
+
+    NSData *contents = [NSData dataWithContentsOfFile:path];
+    WO_TEST_NE(contents, (NSData *)expected);
+    WO_TEST_EQ([WOLogFileSink reassembleData:contents], (NSData *)expected);
+
+    // fragments interleaved with other writers' records (including out of
+    // order), and an incomplete set which should be omitted
+    const char *interleaved =
+        "\036" "1.1 1/2 4\n" "def\n"
+        "plain 1\n"
+        "\036" "2.1 0/2 3\n" "xyz"
+        "\036" "1.1 0/2 3\n" "abc"
+        "plain 2\n";
+    NSData *reassembled = [WOLogFileSink reassembleData:[NSData dataWithBytes:interleaved length:strlen(interleaved)]];
+    WO_TEST_EQ(reassembled, [@"plain 1\nabcdef\nplain 2\n" dataUsingEncoding:NSUTF8StringEncoding]);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+- (void)testManagerFanOut
+{
+    WOLogMemorySink *sink = [[WOLogMemorySink alloc] init];
+    [WOLog addSink:sink];
+    WO_TEST_THROWS([WOLog addSink:nil]);
+    [WOLog logError:@"fan out %d", 42];
+    [WOLog removeSink:sink];
+    [WOLog logError:@"not delivered"];
+
+    NSArray *records = [sink records];
+    WO_TEST_EQ([records count], (NSUInteger)1);
+    NSString *line = [[NSString alloc] initWithData:[[records lastObject] data] encoding:NSUTF8StringEncoding];
+    WO_TEST_TRUE([line hasSuffix:@"Error: fan out 42\n"]);
+}
+
+@end
@@ -0,0 +1,100 @@
+// WOLogSyncerTests.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOLogSyncerTests.h"
+
+// system headers
+#import <dispatch/dispatch.h>
+#import <libkern/OSAtomic.h>
+
+// tested class headers
+#import "WOLogManager.h"
+#import "WOLogSyncer.h"
+
+@implementation WOLogSyncerTests
+
+- (NSString *)temporaryPath
+{
+    NSString *name = WO_STRING(@"WOLogSyncerTests-%@.log", [[NSProcessInfo processInfo] globallyUniqueString]);
+    return [NSTemporaryDirectory() stringByAppendingPathComponent:name];
+}
+
+- (void)testGroupCommit
+{
+    WO_TEST_THROWS([[WOLogSyncer alloc] initWithPath:nil]);
+    NSString *path = [self temporaryPath];
+    WOLogSyncer *syncer = [[WOLogSyncer alloc] initWithPath:path];
+
+    // 256 concurrent requests should be satisfied by fewer syncs
+    __block volatile int32_t failures = 0;
+    dispatch_apply(256, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        if (![syncer sync])
+            OSAtomicIncrement32Barrier(&failures);
+    });
+    WOLogSyncStatistics statistics = [syncer statistics];
+    WO_TEST_EQ(failures, 0);
+    WO_TEST_EQ(statistics.requestCount, 256ULL);
+    WO_TEST_TRUE(statistics.syncCount >= 1);
+    WO_TEST_TRUE(statistics.syncCount <= 256);
+    WO_TEST_EQ(statistics.failureCount, 0ULL);
+    WO_TEST_TRUE(statistics.maximumNanoseconds <= statistics.totalNanoseconds);
+    WO_TEST_TRUE(statistics.p50Nanoseconds > 0);
+    WO_TEST_TRUE(statistics.p50Nanoseconds <= statistics.p99Nanoseconds);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+- (void)testSyncIfDirty
+{
+    NSString *path = [self temporaryPath];
+    WOLogSyncer *syncer = [[WOLogSyncer alloc] initWithPath:path];
+    WO_TEST_TRUE([syncer syncIfDirty]);
+    WO_TEST_EQ([syncer statistics].syncCount, 0ULL);    // nothing written
+    [syncer noteWrite];
+    WO_TEST_TRUE([syncer syncIfDirty]);
+    WO_TEST_EQ([syncer statistics].syncCount, 1ULL);
+    WO_TEST_TRUE([syncer syncIfDirty]);
+    WO_TEST_EQ([syncer statistics].syncCount, 1ULL);    // clean again
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+- (void)testManagerDurability
+{
+    NSString *path = [self temporaryPath];
+    NSString *previousPath = [WOLog logFilePath];
+    [WOLog setLogFilePath:path];
+    [WOLog setDurability:WOLogDurabilityGroupCommit];
+    WO_TEST_EQ([WOLog durability], WOLogDurabilityGroupCommit);
+    [WOLog logToFileError:@"durable %d", 1];
+    WO_TEST_EQ([WOLog syncStatistics].requestCount, 1ULL);
+    WO_TEST_TRUE([WOLog syncLogFile]);
+    WO_TEST_EQ([WOLog syncStatistics].requestCount, 2ULL);
+    [WOLog setDurability:WOLogDurabilityNone];
+    [WOLog setLogFilePath:previousPath];
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+@end
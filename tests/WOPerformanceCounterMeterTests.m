@@ -0,0 +1,85 @@
+// WOPerformanceCounterMeterTests.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOPerformanceCounterMeterTests.h"
+
+// tested class headers
+#import "WOPerformanceCounterMeter.h"
+
+@implementation WOPerformanceCounterMeterTests
+
+- (void)testCounting
+{
+    WOPerformanceCounterMeter *meter = [WOPerformanceCounterMeter counterMeter];
+    volatile unsigned long counter = 0;
+    for (unsigned long i = 0; i < 1000000; i++)
+        counter += i;
+    [meter pause];
+
+    if (![meter isAvailable])
+    {
+        // unavailable counters are never reported as zero
+        for (unsigned i = 0; i < WOPerformanceCounterCount; i++)
+        {
+            WO_TEST_FALSE([meter isCounterAvailable:i]);
+            WO_TEST_EQ([meter valueForCounter:i], WO_PERFORMANCE_COUNTER_UNAVAILABLE);
+        }
+        WO_TEST_EQ([[meter counterDictionary] objectForKey:@"cycles"], [NSNull null]);
+        WO_TEST_TRUE([[meter counterString] rangeOfString:@"cycles unavailable"].location != NSNotFound);
+        return;
+    }
+
+    if ([meter isCounterAvailable:WOPerformanceCounterInstructions])
+    {
+        int64_t instructions = [meter valueForCounter:WOPerformanceCounterInstructions];
+        WO_TEST_TRUE(instructions >= 1000000);
+
+        // paused meter does not advance
+        for (unsigned long i = 0; i < 1000000; i++)
+            counter += i;
+        WO_TEST_EQ([meter valueForCounter:WOPerformanceCounterInstructions], instructions);
+
+        // stacked resume/pause
+        [meter resume];
+        [meter resume];
+        [meter pause];
+        for (unsigned long i = 0; i < 1000000; i++)
+            counter += i;
+        [meter pause];
+        WO_TEST_TRUE([meter valueForCounter:WOPerformanceCounterInstructions] >= instructions + 1000000);
+        WO_TEST_TRUE([[[meter counterDictionary] objectForKey:@"instructions"] isKindOfClass:[NSNumber class]]);
+    }
+}
+
+- (void)testOutOfRangeCounter
+{
+    WOPerformanceCounterMeter *meter = [WOPerformanceCounterMeter counterMeter];
+    WO_TEST_FALSE([meter isCounterAvailable:WOPerformanceCounterCount]);
+    WO_TEST_EQ([meter valueForCounter:WOPerformanceCounterCount], WO_PERFORMANCE_COUNTER_UNAVAILABLE);
+}
+
+@end
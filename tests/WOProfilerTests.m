@@ -0,0 +1,137 @@
+// WOProfilerTests.m
+// WOPublic
+//
+// Copyright 2026-present Greg Hurrell. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// class header
+#import "WOProfilerTests.h"
+
+// system headers
+#import <unistd.h>      /* usleep() */
+
+// tested class headers
+#import "WOProfiler.h"
+
+@implementation WOProfilerTests
+
+- (void)recordInner:(WOProfiler *)profiler
+{
+    WO_PROFILE_SCOPE(profiler, "inner");
+    usleep(2000);
+}
+
+- (void)recordOuter:(WOProfiler *)profiler
+{
+    WO_PROFILE_SCOPE(profiler, "outer");
+    usleep(1000);
+    [self recordInner:profiler];
+    [self recordInner:profiler];
+}
+
+- (void)testFoldedStacks
+{
+    WOProfiler *profiler = [[WOProfiler alloc] init];
+    for (unsigned i = 0; i < 3; i++)
+        [self recordOuter:profiler];
+
+    NSString *folded = [profiler foldedStacks];
+    NSArray *lines = [[folded stringByTrimmingCharactersInSet:[NSCharacterSet newlineCharacterSet]] componentsSeparatedByString:@"\n"];
+    WO_TEST_EQ([lines count], (NSUInteger)2);
+    WO_TEST_TRUE([[lines objectAtIndex:0] hasPrefix:@"outer "]);
+    WO_TEST_TRUE([[lines objectAtIndex:1] hasPrefix:@"outer;inner "]);
+
+    // self time excludes children: outer sleeps 1ms per call, inner 2ms (x2)
+    long long outerSelf = [[[[lines objectAtIndex:0] componentsSeparatedByString:@" "] lastObject] longLongValue];
+    long long innerSelf = [[[[lines objectAtIndex:1] componentsSeparatedByString:@" "] lastObject] longLongValue];
+    WO_TEST_TRUE(outerSelf >= 3 * 1000000LL);
+    WO_TEST_TRUE(innerSelf >= 12 * 1000000LL);
+    WO_TEST_TRUE(outerSelf < innerSelf);
+}
+
+- (void)testJSONRepresentation
+{
+    WOProfiler *profiler = [[WOProfiler alloc] init];
+    [profiler enterScope:"a \"quoted\" name"];
+    [profiler exitScope];
+    [self recordOuter:profiler];
+    NSString *json = [profiler JSONRepresentation];
+    WO_TEST_TRUE([json hasPrefix:@"{\"name\":\"root\",\"count\":2,"]);
+    WO_TEST_TRUE([json rangeOfString:@"\"name\":\"a \\\"quoted\\\" name\",\"count\":1,"].location != NSNotFound);
+    WO_TEST_TRUE([json rangeOfString:@"\"name\":\"inner\",\"count\":2,"].location != NSNotFound);
+    WO_TEST_TRUE([json rangeOfString:@"cpu"].location == NSNotFound);
+
+    profiler = [[WOProfiler alloc] init];
+    [profiler setMeasuresProcessorTime:YES];
+    [self recordOuter:profiler];
+    WO_TEST_TRUE([[profiler JSONRepresentation] rangeOfString:@"\"self_cpu_ns\":"].location != NSNotFound);
+}
+
+- (void)recordOnThread:(WOProfiler *)profiler
+{
+    [self recordOuter:profiler];
+}
+
+- (void)testThreadsAreMerged
+{
+    WOProfiler *profiler = [[WOProfiler alloc] init];
+    [self recordOuter:profiler];
+    [NSThread detachNewThreadSelector:@selector(recordOnThread:) toTarget:self withObject:profiler];
+    [NSThread detachNewThreadSelector:@selector(recordOnThread:) toTarget:self withObject:profiler];
+    usleep(200000);
+    WO_TEST_TRUE([[profiler JSONRepresentation] rangeOfString:@"\"name\":\"outer\",\"count\":3,"].location != NSNotFound);
+    WO_TEST_TRUE([[profiler JSONRepresentation] rangeOfString:@"\"name\":\"inner\",\"count\":6,"].location != NSNotFound);
+}
+
+- (void)testReset
+{
+    WOProfiler *profiler = [[WOProfiler alloc] init];
+    [self recordOuter:profiler];
+    [profiler reset];
+    WO_TEST_EQ([[profiler foldedStacks] length], (NSUInteger)0);
+    [self recordOuter:profiler];
+    WO_TEST_TRUE([[profiler JSONRepresentation] rangeOfString:@"\"name\":\"outer\",\"count\":1,"].location != NSNotFound);
+}
+
+- (void)testUnbalancedExit
+{
+    WOProfiler *profiler = [[WOProfiler alloc] init];
+    WO_TEST_THROWS([profiler exitScope]);
+    [profiler enterScope:"scope"];
+    [profiler exitScope];
+    WO_TEST_THROWS([profiler exitScope]);
+}
+
+- (void)testDeepNesting
+{
+    // deeper than the initial stack, so the stack has to grow
+    WOProfiler *profiler = [[WOProfiler alloc] init];
+    for (unsigned i = 0; i < 100; i++)
+        [profiler enterScope:"level"];
+    for (unsigned i = 0; i < 100; i++)
+        [profiler exitScope];
+    NSArray *components = [[profiler JSONRepresentation] componentsSeparatedByString:@"\"name\":\"level\""];
+    WO_TEST_EQ([components count], (NSUInteger)101);
+}
+
+@end
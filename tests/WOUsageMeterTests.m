@@ -27,11 +27,273 @@
 // class header
 #import "WOUsageMeterTests.h"
 
+// system headers
+#import <libkern/OSAtomic.h>    /* OSAtomicIncrement32Barrier() */
+#import <unistd.h>              /* usleep() */
+
 // tested class header
 #import "WOUsageMeter.h"
 
+#pragma mark -
+#pragma mark Helper functions
+
+static void WOUsageMeterTestsSpin(NSTimeInterval seconds)
+{
+    volatile unsigned long counter = 0;
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:seconds];
+    while ([deadline timeIntervalSinceNow] > 0)
+        for (unsigned i = 0; i < 100000; i++)
+            counter++;
+}
+
+//! Number of background threads which completed their work without raising
+static volatile int32_t WOUsageMeterTestsCompleted;
+
+static long long WOUsageMeterTestsMicroseconds(struct timeval time)
+{
+    return (long long)time.tv_sec * 1000000 + time.tv_usec;
+}
+
 @implementation WOUsageMeterTests
 
+- (void)spinInBackground:(id)ignored
+{
+    WOUsageMeterTestsSpin(0.25);
+}
+
+- (void)resumeAndPause:(WOUsageMeter *)meter
+{
+    [meter resume];
+    WOUsageMeterTestsSpin(0.1);
+    [meter pause];
+}
+
+- (void)testThreadScope
+{
+    WOUsageMeter *process   = [WOUsageMeter usageMeter];
+    WOUsageMeter *thread    = [WOUsageMeter threadUsageMeter];
+    WO_TEST_EQ([process scope], WOUsageMeterProcessScope);
+    WO_TEST_EQ([thread scope], WOUsageMeterThreadScope);
+
+    // busy background threads should show up in the process meter only
+    [NSThread detachNewThreadSelector:@selector(spinInBackground:) toTarget:self withObject:nil];
+    [NSThread detachNewThreadSelector:@selector(spinInBackground:) toTarget:self withObject:nil];
+    usleep(400000);
+    [process pause];
+    [thread pause];
+    struct timeval processUsage = [process usage];
+    struct timeval threadUsage  = [thread usage];
+    WO_TEST_TRUE(WOUsageMeterTestsMicroseconds(processUsage) > 200000);
+    WO_TEST_TRUE(WOUsageMeterTestsMicroseconds(threadUsage) < 100000);
+
+    // paused meter does not advance
+    WOUsageMeterTestsSpin(0.05);
+    struct timeval later = [thread usage];
+    WO_TEST_EQ(later.tv_sec, threadUsage.tv_sec);
+    WO_TEST_EQ(later.tv_usec, threadUsage.tv_usec);
+}
+
+- (void)testThreadScopePauseCounts
+{
+    // pause count is per-thread: another thread resuming does not start this thread's interval
+    WOUsageMeter *meter = [WOUsageMeter threadUsageMeter];
+    [meter pause];
+    [NSThread detachNewThreadSelector:@selector(resumeAndPause:) toTarget:self withObject:meter];
+    usleep(300000);
+    struct timeval usage = [meter usage];
+    WO_TEST_TRUE(WOUsageMeterTestsMicroseconds(usage) > 50000);
+
+    // stacked resume/pause on this thread
+    [meter resume];
+    [meter resume];
+    [meter pause];
+    WOUsageMeterTestsSpin(0.1);
+    struct timeval running = [meter usage];
+    [meter pause];
+    struct timeval paused = [meter usage];
+    WO_TEST_TRUE(WOUsageMeterTestsMicroseconds(running) > WOUsageMeterTestsMicroseconds(usage));
+    WO_TEST_TRUE(WOUsageMeterTestsMicroseconds(paused) >= WOUsageMeterTestsMicroseconds(running));
+}
+
+- (void)readMeter:(WOUsageMeter *)meter
+{
+    @try
+    {
+        [meter usage];
+        OSAtomicIncrement32Barrier(&WOUsageMeterTestsCompleted);
+    }
+    @catch (NSException *e) {}
+}
+
+- (void)resumePauseMeter:(WOUsageMeter *)meter
+{
+    @try
+    {
+        [meter resume];
+        [meter pause];
+        OSAtomicIncrement32Barrier(&WOUsageMeterTestsCompleted);
+    }
+    @catch (NSException *e) {}
+}
+
+- (void)testThreadScopeEntries
+{
+    const int32_t   count   = 2 * WO_USAGE_METER_MAX_THREADS;
+    WOUsageMeter    *meter  = [WOUsageMeter threadUsageMeter];
+    [meter pause];
+
+    // readers never claim an entry, so any number of threads may read
+    WOUsageMeterTestsCompleted = 0;
+    for (int32_t i = 0; i < count; i++)
+        [NSThread detachNewThreadSelector:@selector(readMeter:) toTarget:self withObject:meter];
+    for (unsigned tries = 0; WOUsageMeterTestsCompleted < count && tries < 500; tries++)
+        usleep(10000);
+    WO_TEST_EQ(WOUsageMeterTestsCompleted, count);
+
+    // entries are released on pause, so threads taking turns never run out
+    WOUsageMeterTestsCompleted = 0;
+    for (int32_t i = 0; i < count; i++)
+    {
+        [NSThread detachNewThreadSelector:@selector(resumePauseMeter:) toTarget:self withObject:meter];
+        for (unsigned tries = 0; WOUsageMeterTestsCompleted <= i && tries < 500; tries++)
+            usleep(1000);
+    }
+    WO_TEST_EQ(WOUsageMeterTestsCompleted, count);
+
+    // and the meter remains paused on this thread
+    struct timeval usage = [meter usage];
+    WOUsageMeterTestsSpin(0.05);
+    struct timeval later = [meter usage];
+    WO_TEST_EQ(later.tv_sec, usage.tv_sec);
+    WO_TEST_EQ(later.tv_usec, usage.tv_usec);
+}
+
+- (void)testMonotonicNanoseconds
+{
+    WONanoseconds start = WOMonotonicNanoseconds();
+    usleep(20000);
+    WONanoseconds elapsed = WOMonotonicNanoseconds() - start;
+    WO_TEST_TRUE(elapsed >= 20 * 1000000LL);
+    WO_TEST_TRUE(elapsed < WO_NANOSECONDS_PER_SECOND);
+
+    // never goes backwards; reads are cheap (generous bound, the clock itself is tens of nanoseconds)
+    const unsigned count = 100000;
+    WONanoseconds previous = WOMonotonicNanoseconds();
+    BOOL monotonic = YES;
+    for (unsigned i = 0; i < count; i++)
+    {
+        WONanoseconds now = WOMonotonicNanoseconds();
+        if (now < previous)
+            monotonic = NO;
+        previous = now;
+    }
+    WO_TEST_TRUE(monotonic);
+    WO_TEST_TRUE((previous - start) / count < 1000);
+}
+
+- (void)testNanosecondConversions
+{
+    struct timeval time = WONanosecondsToTimeval(3500000999LL);
+    WO_TEST_EQ(time.tv_sec, 3);
+    WO_TEST_EQ(time.tv_usec, 500000);
+    time = WONanosecondsToTimeval(-1500000000LL);
+    WO_TEST_EQ(time.tv_sec, -1);
+    WO_TEST_EQ(time.tv_usec, -500000);
+
+    // non-normalized input
+    time.tv_sec     = 2;
+    time.tv_usec    = -500000;
+    WO_TEST_EQ(WOTimevalToNanoseconds(time), 1500000000LL);
+}
+
+- (void)testWallTime
+{
+    WOUsageMeter *meter = [WOUsageMeter usageMeter];
+    usleep(50000);
+    [meter pause];
+    WONanoseconds wall = [meter wallNanoseconds];
+    WO_TEST_TRUE(wall >= 50 * 1000000LL);
+    WO_TEST_TRUE([meter usageNanoseconds] < wall);  // mostly asleep
+    usleep(10000);
+    WO_TEST_EQ([meter wallNanoseconds], wall);      // paused
+}
+
+- (void)hammerMeter:(WOUsageMeter *)meter
+{
+    for (unsigned i = 0; i < 10000; i++)
+    {
+        [meter resume];
+        [meter pause];
+    }
+}
+
+- (void)testConcurrentPauseResume
+{
+    WOUsageMeter *meter = [WOUsageMeter usageMeter];
+    [meter pause];
+    for (unsigned i = 0; i < 4; i++)
+        [NSThread detachNewThreadSelector:@selector(hammerMeter:) toTarget:self withObject:meter];
+
+    // readers see monotonically increasing totals while writers are busy
+    WONanoseconds previous = 0;
+    BOOL monotonic = YES;
+    for (unsigned i = 0; i < 10000; i++)
+    {
+        WONanoseconds wall = [meter wallNanoseconds];
+        if (wall < previous)
+            monotonic = NO;
+        previous = wall;
+    }
+    WO_TEST_TRUE(monotonic);
+
+    // once the writers are done the meter is paused again
+    usleep(500000);
+    WONanoseconds wall = [meter wallNanoseconds];
+    usleep(10000);
+    WO_TEST_EQ([meter wallNanoseconds], wall);
+}
+
+- (void)testOverhead
+{
+    // nested pause/resume is atomics only: generous bound to allow for loaded test machines
+    WO_TEST_TRUE([WOUsageMeter overheadForScope:WOUsageMeterProcessScope nested:YES] < 1000);
+    WO_TEST_TRUE([WOUsageMeter overheadForScope:WOUsageMeterThreadScope nested:YES] < 1000);
+    WO_TEST_TRUE([WOUsageMeter overheadForScope:WOUsageMeterProcessScope nested:NO] > 0);
+}
+
+- (void)testCounters
+{
+    WOUsageMeter *meter = [WOUsageMeter usageMeter];
+
+    // first touches of fresh pages are minor faults; sleeping is a voluntary switch
+    size_t size = 16 * 1024 * 1024;
+    char *buffer = malloc(size);
+    for (size_t i = 0; i < size; i += 4096)
+        buffer[i] = 1;
+    free(buffer);
+    for (unsigned i = 0; i < 5; i++)
+        usleep(1000);
+    [meter pause];
+
+    WOUsageCounters counters = [meter counters];
+    WO_TEST_TRUE(counters.minorFaults > 0);
+    WO_TEST_TRUE(counters.voluntaryContextSwitches > 0);
+    WO_TEST_TRUE(counters.maximumResidentSetSize > (int64_t)size);
+
+    // paused meter does not advance
+    buffer = malloc(size);
+    for (size_t i = 0; i < size; i += 4096)
+        buffer[i] = 1;
+    free(buffer);
+    WO_TEST_EQ([meter counters].minorFaults, counters.minorFaults);
+
+    NSDictionary *dictionary = [meter usageDictionary];
+    WO_TEST_EQ([[dictionary objectForKey:@"minorFaults"] longLongValue], counters.minorFaults);
+    WO_TEST_NOT_NIL([dictionary objectForKey:@"wallNanoseconds"]);
+    WO_TEST_NOT_NIL([dictionary objectForKey:@"blockOutputOperations"]);
+    WO_TEST_TRUE([[meter usageString] rangeOfString:@"faults (minor/major)"].location != NSNotFound);
+}
+
 - (void)testNormalizeTimeval
 {
     // preliminaries